@@ -0,0 +1,73 @@
+; ---------------------------------------------------------------------------
+; Tervia Cinser OS - Sistema Operacional
+; Desenvolvido por: Tervia Corporation (2026)
+; 
+; Licença: GNU GPLv3
+; Este arquivo faz parte do projeto Tervia Cinser. 
+; Você tem a liberdade de estudar, modificar e distribuir este código
+; desde que mantenha esta licença original.
+; ---------------------------------------------------------------------------
+; Descrição: Trampolim de partida dos APs (modo real -> modo protegido).
+; ---------------------------------------------------------------------------
+;
+; kernel/smp.c copia ap_trampoline_start..ap_trampoline_end para
+; SMP_TRAMPOLINE (0x7000) e manda o SIPI com o vetor 0x07: o AP comeca em
+; 0700:0000 em modo real. Tudo aqui e endereçado pelo endereco da copia
+; (TRAMP), nunca pelo do kernel. Antes de cada AP o BSP preenche
+; ap_trampoline_stack (topo da pilha do AP) e ap_trampoline_entry (C).
+
+%define TRAMP_BASE 0x7000
+%define TRAMP(x) (TRAMP_BASE + ((x) - ap_trampoline_start))
+
+GLOBAL ap_trampoline_start
+GLOBAL ap_trampoline_end
+GLOBAL ap_trampoline_stack
+GLOBAL ap_trampoline_entry
+
+SECTION .text
+
+BITS 16
+ap_trampoline_start:
+    cli
+    cld
+    xor ax, ax
+    mov ds, ax
+    lgdt [TRAMP(tramp_gdtr)]
+
+    mov eax, cr0
+    or eax, 1                       ; PE
+    mov cr0, eax
+    jmp dword 0x08:TRAMP(tramp_pm)
+
+BITS 32
+tramp_pm:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+    mov esp, [TRAMP(ap_trampoline_stack)]
+    call [TRAMP(ap_trampoline_entry)]
+
+.hang:                              ; ap_entry nao volta
+    cli
+    hlt
+    jmp .hang
+
+align 8
+tramp_gdt:
+    dq 0x0000000000000000           ; null
+    dq 0x00CF9A000000FFFF           ; 0x08: code (base=0, limit=4GB)
+    dq 0x00CF92000000FFFF           ; 0x10: data (base=0, limit=4GB)
+
+tramp_gdtr:
+    dw tramp_gdtr - tramp_gdt - 1
+    dd TRAMP(tramp_gdt)
+
+align 4
+ap_trampoline_stack:
+    dd 0
+ap_trampoline_entry:
+    dd 0
+ap_trampoline_end:
@@ -7,6 +7,14 @@ BITS 32
 ;   - isr_handler(regs_t*) for CPU exceptions (0-31)
 ;   - irq_dispatch(regs_t*) for PIC IRQs (mapped to 0x20-0x2F)
 ;
+; IRQs that interrupt ring 0 take irq_fast instead: the segment registers
+; already hold the kernel selectors, so they are saved for the regs_t layout
+; but never reloaded, and the handler is called straight from
+; irq_vector_table (kernel/irq.c) followed by irq_exit().
+;
+; Every stub clears DF before calling C: the interrupted code may be inside
+; a backward string copy (std; rep movs), and iret restores its EFLAGS.
+;
 ; Stack layout matches include/isr.h regs_t:
 ;   gs, fs, es, ds, edi, esi, ebp, esp, ebx, edx, ecx, eax, int_no, err_code,
 ;   eip, cs, eflags, useresp, ss
@@ -19,9 +27,15 @@ GLOBAL isr24, isr25, isr26, isr27, isr28, isr29, isr30, isr31
 
 GLOBAL irq0, irq1, irq2, irq3, irq4, irq5, irq6, irq7
 GLOBAL irq8, irq9, irq10, irq11, irq12, irq13, irq14, irq15
+GLOBAL irq_spurious
+GLOBAL irq_ipi_call
+GLOBAL irq_bench_fast, irq_bench_slow
 
 EXTERN isr_handler
 EXTERN irq_dispatch
+EXTERN irq_entry_tsc, irqstat_tsc, irqstat_spurious
+EXTERN irq_vector_table, irq_exit
+EXTERN smp_ipi_handler
 
 %macro ISR_NOERR 1
 isr%1:
@@ -40,6 +54,8 @@ isr%1:
 irq%1:
     push dword 0          ; err_code
     push dword (0x20 + %1); int_no
+    test byte [esp + 12], 3   ; RPL of the interrupted CS
+    jz irq_fast
     jmp irq_common
 %endmacro
 
@@ -98,10 +114,22 @@ IRQ_STUB 13
 IRQ_STUB 14
 IRQ_STUB 15
 
+; Benchmark vector (irqbench): same int_no through both paths, no EOI
+irq_bench_fast:
+    push dword 0
+    push dword 0x30
+    jmp irq_fast
+
+irq_bench_slow:
+    push dword 0
+    push dword 0x30
+    jmp irq_common
+
 ; ---------------- Common stubs ----------------
 
 isr_common:
     pusha
+    cld
     push ds
     push es
     push fs
@@ -128,6 +156,15 @@ isr_common:
 
 irq_common:
     pusha
+    cld
+
+    ; Entry timestamp for irqstat (kernel/irqstat.c), only when a TSC exists
+    cmp byte [irqstat_tsc], 0
+    je .no_tsc
+    rdtsc
+    mov [irq_entry_tsc], eax
+    mov [irq_entry_tsc + 4], edx
+.no_tsc:
     push ds
     push es
     push fs
@@ -151,3 +188,50 @@ irq_common:
 
     add esp, 8            ; pop int_no + err_code
     iret
+
+
+; Ring 0 only: DS/ES/FS/GS are pushed so the frame is a regs_t, but the
+; kernel selectors are already loaded, so nothing is reloaded or popped.
+irq_fast:
+    pusha
+    cld
+
+    cmp byte [irqstat_tsc], 0
+    je .no_tsc
+    rdtsc
+    mov [irq_entry_tsc], eax
+    mov [irq_entry_tsc + 4], edx
+.no_tsc:
+    push ds
+    push es
+    push fs
+    push gs
+
+    mov eax, [esp + 48]   ; int_no
+    push esp
+    call [irq_vector_table + eax * 4 - 0x20 * 4]
+    add esp, 4
+
+    push esp              ; the callee may clobber its argument slot
+    call irq_exit
+    add esp, 4
+
+    add esp, 16           ; gs, fs, es, ds: unchanged
+    popa
+
+    add esp, 8            ; pop int_no + err_code
+    iret
+
+; LAPIC spurious vector (0xFF): no EOI, nothing to do
+irq_spurious:
+    inc dword [irqstat_spurious]
+    iret
+
+; Cross-CPU call IPI (SMP_IPI_VECTOR, include/smp.h): only wakes the AP's
+; idle loop, which runs the call; the handler just sends the EOI
+irq_ipi_call:
+    pusha
+    cld
+    call smp_ipi_handler
+    popa
+    iret
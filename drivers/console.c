@@ -15,7 +15,11 @@
  ****************************************************************************/
 
 #include "video.h"
+#include "vga.h"
 #include "font.h"
+#include "time.h"
+#include "idle.h"
+#include "sched.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -28,8 +32,14 @@ static void console_recompute_dims(void);
 //  - scroll quando a tela enche
 //  - backspace que apaga na tela (além de mover o cursor)
 //  - compatível com qualquer driver de vídeo (usa apenas put_pixel/clear_screen/fill_rect)
+//
+// Sem framebuffer (GRUB em modo texto), tudo vai para o backend vgatext
+// (vga.c), que escreve direto em 0xB8000.
 // ---------------------------------------------------------------------------
 
+// 1 = sem driver de video, console em modo texto VGA
+static int g_text_mode = 0;
+
 // Runtime font copy (protege contra corrupção de .rodata em certos caminhos)
 #define FONT_GLYPHS 129
 static uint8_t g_font_runtime[FONT_GLYPHS][8];
@@ -74,6 +84,45 @@ typedef struct {
 
 static console_cell_t g_cells[CONSOLE_MAX_ROWS][CONSOLE_MAX_COLS];
 
+// Present adiado: ver console_defer_present()
+#define CONSOLE_PRESENT_MS 20
+static int g_defer = 0;
+static int g_present_pending = 0;
+static uint32_t g_last_present = 0;
+
+static void console_present_now(void) {
+    g_present_pending = 0;
+    g_last_present = time_get_ticks();
+    if (g_video_driver && g_video_driver->update) g_video_driver->update();
+}
+
+static void console_present(void) {
+    if (g_defer && time_get_ticks() - g_last_present < CONSOLE_PRESENT_MS) {
+        g_present_pending = 1;
+        return;
+    }
+    console_present_now();
+}
+
+static int console_idle_flush(void* arg) {
+    (void)arg;
+    if (!g_present_pending) return 0;
+    console_present_now();
+    return 1;
+}
+
+static idle_work_t g_console_idle = { "console", console_idle_flush, 0, 0, 0 };
+static int g_console_idle_registered = 0;
+
+void console_defer_present(int on) {
+    if (on && !g_console_idle_registered) {
+        idle_register(&g_console_idle);
+        g_console_idle_registered = 1;
+    }
+    g_defer = on ? 1 : 0;
+    if (!g_defer && g_present_pending) console_present_now();
+}
+
 static inline int min_i(int a, int b) { return (a < b) ? a : b; }
 
 static void console_recalc_geometry(void) {
@@ -164,7 +213,7 @@ static void console_redraw_all(void) {
             draw_glyph_at(x, y, g_cells[y][x].ch, g_cells[y][x].fg, g_cells[y][x].bg);
         }
     }
-    if (g_video_driver->update) g_video_driver->update();
+    console_present();
 }
 
 static void console_scroll_up(void) {
@@ -208,9 +257,11 @@ void console_set_color(uint8_t fg, uint8_t bg) {
 
     fg_color = vga_palette[fg & 0x0F];
     bg_color = vga_palette[bg & 0x0F];
+    if (g_text_mode) vgatext_set_color(fg, bg);
 }
 
 void console_clear(void) {
+    if (g_text_mode) { vgatext_clear(); return; }
     if (!g_video_driver) return;
     font_runtime_init();
     console_recalc_geometry();
@@ -218,10 +269,11 @@ void console_clear(void) {
     g_cur_col = 0;
     g_cur_row = 0;
     console_fill_bg();
-    if (g_video_driver->update) g_video_driver->update();
+    console_present();
 }
 
-void console_putc(char c) {
+static void putc_locked(char c) {
+    if (g_text_mode) { vgatext_putc(c); return; }
     if (!g_video_driver) return;
     font_runtime_init();
     console_recalc_geometry();
@@ -278,14 +330,31 @@ void console_putc(char c) {
         }
     }
 
-    if (g_video_driver->update) g_video_driver->update();
+    console_present();
+}
+
+// Celulas, cursor e present sao compartilhados: sem troca de thread no meio
+void console_putc(char c) {
+    preempt_disable();
+    putc_locked(c);
+    preempt_enable();
 }
 
 void console_write(const char* str) {
+    if (g_text_mode) { vgatext_write(str); return; }
     while (*str) console_putc(*str++);
 }
 
 void console_init(void) {
+    // Chamado depois de video_init_system(): sem driver => modo texto
+    g_text_mode = (g_video_driver == 0);
+    if (g_text_mode) {
+        g_cols = VGA_TEXT_COLS;
+        g_rows = VGA_TEXT_ROWS;
+        vgatext_init();
+        return;
+    }
+
     font_runtime_init();
     console_recalc_geometry();
     console_clear_cells();
@@ -299,6 +368,7 @@ int console_get_cols(void) { return g_cols; }
 int console_get_rows(void) { return g_rows; }
 
 void console_set_cursor(int col, int row) {
+    if (g_text_mode) { vgatext_set_cursor(col, row); return; }
     console_recompute_dims();
     if (col < 0) col = 0;
     if (row < 0) row = 0;
@@ -309,6 +379,7 @@ void console_set_cursor(int col, int row) {
 }
 
 void console_get_cursor(int* col, int* row) {
+    if (g_text_mode) { vgatext_get_cursor(col, row); return; }
     if (col) *col = g_cur_col;
     if (row) *row = g_cur_row;
 }
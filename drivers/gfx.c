@@ -0,0 +1,233 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: gfx.c
+ * Descricao: Primitivas 2D (fill, blend, gradientes, blit com alpha) com SSE2.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include "gfx.h"
+#include "cpu.h"
+#include "fpu.h"
+
+// ---------------------------------------------------------------------------
+// Kernels escalares (sempre disponiveis)
+// ---------------------------------------------------------------------------
+
+static inline void copy32(uint32_t* d, const uint32_t* s, int n) {
+    int d0, d1, d2;
+    __asm__ volatile (
+        "cld; rep movsl"
+        : "=&D"(d0), "=&S"(d1), "=&c"(d2)
+        : "0"(d), "1"(s), "2"(n)
+        : "memory", "cc"
+    );
+}
+
+static void scalar_fill(uint32_t* d, uint32_t color, int n) {
+    int d0, d1;
+    __asm__ volatile (
+        "cld; rep stosl"
+        : "=&D"(d0), "=&c"(d1)
+        : "0"(d), "a"(color), "1"(n)
+        : "memory", "cc"
+    );
+}
+
+// Source-over com arredondamento exato de /255: (t + (t >> 8)) >> 8.
+// O caminho SSE2 faz a mesma conta, entao os dois dao o mesmo resultado.
+static inline uint32_t blend_px(uint32_t d, uint32_t s) {
+    uint32_t a = s >> 24;
+    if (a == 0xFFu) return s & 0x00FFFFFFu;
+    if (a == 0) return d;
+    uint32_t ia = 255u - a;
+    uint32_t rb = (s & 0x00FF00FFu) * a + (d & 0x00FF00FFu) * ia + 0x00800080u;
+    uint32_t g  = (s & 0x0000FF00u) * a + (d & 0x0000FF00u) * ia + 0x00008000u;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+    g  = ((g  + ((g  >> 8) & 0x0000FF00u)) >> 8) & 0x0000FF00u;
+    return rb | g;
+}
+
+static void scalar_blend(uint32_t* d, const uint32_t* s, int n) {
+    for (int i = 0; i < n; i++) d[i] = blend_px(d[i], s[i]);
+}
+
+static void scalar_blend_const(uint32_t* d, uint32_t argb, int n) {
+    uint32_t a = argb >> 24;
+    if (a == 0) return;
+    if (a == 0xFFu) { scalar_fill(d, argb & 0x00FFFFFFu, n); return; }
+    uint32_t ia = 255u - a;
+    uint32_t srb = (argb & 0x00FF00FFu) * a + 0x00800080u;
+    uint32_t sg  = (argb & 0x0000FF00u) * a + 0x00008000u;
+    for (int i = 0; i < n; i++) {
+        uint32_t rb = srb + (d[i] & 0x00FF00FFu) * ia;
+        uint32_t g  = sg  + (d[i] & 0x0000FF00u) * ia;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        g  = ((g  + ((g  >> 8) & 0x0000FF00u)) >> 8) & 0x0000FF00u;
+        d[i] = rb | g;
+    }
+}
+
+static const gfx_span_ops_t g_scalar_ops = {
+    .fill        = scalar_fill,
+    .blend       = scalar_blend,
+    .blend_const = scalar_blend_const,
+};
+
+// ---------------------------------------------------------------------------
+// Deteccao / selecao
+// ---------------------------------------------------------------------------
+
+static const gfx_span_ops_t* g_ops = &g_scalar_ops;
+static int g_backend = GFX_BACKEND_SCALAR;
+static int g_sse2_ok = 0;
+
+// Da melhor para a generica. O SSE ja foi ligado no CR4 pelo fpu_init().
+static const cpu_variant_t g_span_variants[] = {
+    { CPU_F(CPU_SSE2) | CPU_F(CPU_FXSR), &gfx_sse2_ops, "sse2"   },
+    { 0,                                 &g_scalar_ops, "scalar" },
+};
+
+void gfx_init(void) {
+    const cpu_variant_t* v = cpu_select(g_span_variants, 2);
+    g_sse2_ok = (v->impl == &gfx_sse2_ops);
+    gfx_set_backend(g_sse2_ok ? GFX_BACKEND_SSE2 : GFX_BACKEND_SCALAR);
+}
+
+int gfx_set_backend(int backend) {
+    if (backend == GFX_BACKEND_SSE2) {
+        if (!g_sse2_ok) return 0;
+        g_ops = &gfx_sse2_ops;
+    } else {
+        g_ops = &g_scalar_ops;
+        backend = GFX_BACKEND_SCALAR;
+    }
+    g_backend = backend;
+    return 1;
+}
+
+int gfx_backend(void) {
+    return g_backend;
+}
+
+const char* gfx_backend_name(void) {
+    return (g_backend == GFX_BACKEND_SSE2) ? "SSE2" : "scalar";
+}
+
+// ---------------------------------------------------------------------------
+// Primitivas (clip + laco de linhas)
+// ---------------------------------------------------------------------------
+
+// Clipa [x,y,w,h] contra a superficie. sx/sy recebem o deslocamento aplicado
+// (para ajustar a fonte em blits). Retorna 0 se nada sobrou.
+static int clip(const gfx_surface_t* dst, int* x, int* y, int* w, int* h, int* sx, int* sy) {
+    *sx = 0; *sy = 0;
+    if (*x < 0) { *sx = -*x; *w += *x; *x = 0; }
+    if (*y < 0) { *sy = -*y; *h += *y; *y = 0; }
+    if (*x + *w > dst->w) *w = dst->w - *x;
+    if (*y + *h > dst->h) *h = dst->h - *y;
+    return (*w > 0 && *h > 0);
+}
+
+// Os kernels SSE2 usam os XMM: a primitiva inteira vira uma regiao SIMD.
+// Sem nivel de aninhamento livre no fpu.c a primitiva roda no escalar.
+static inline const gfx_span_ops_t* simd_begin(void) {
+    if (g_ops == &g_scalar_ops || !kernel_fpu_usable()) return &g_scalar_ops;
+    kernel_fpu_begin();
+    return g_ops;
+}
+
+static inline void simd_end(const gfx_span_ops_t* ops) {
+    if (ops != &g_scalar_ops) kernel_fpu_end();
+}
+
+static inline uint32_t* row_at(gfx_surface_t* dst, int x, int y) {
+    return dst->pixels + (uint32_t)y * (uint32_t)dst->stride + (uint32_t)x;
+}
+
+void gfx_fill(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t color) {
+    int sx, sy;
+    if (!dst || !clip(dst, &x, &y, &w, &h, &sx, &sy)) return;
+    color &= 0x00FFFFFFu;
+    const gfx_span_ops_t* ops = simd_begin();
+    for (int r = 0; r < h; r++) ops->fill(row_at(dst, x, y + r), color, w);
+    simd_end(ops);
+}
+
+void gfx_blend_fill(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t argb) {
+    int sx, sy;
+    if (!dst || !clip(dst, &x, &y, &w, &h, &sx, &sy)) return;
+    const gfx_span_ops_t* ops = simd_begin();
+    for (int r = 0; r < h; r++) ops->blend_const(row_at(dst, x, y + r), argb, w);
+    simd_end(ops);
+}
+
+// Interpola c0->c1 em n passos (16.16 por canal); i vai de 0 a n-1.
+typedef struct { int32_t r, g, b, dr, dg, db; } lerp_t;
+
+static void lerp_init(lerp_t* l, uint32_t c0, uint32_t c1, int n) {
+    int32_t r0 = (int32_t)((c0 >> 16) & 0xFFu), r1 = (int32_t)((c1 >> 16) & 0xFFu);
+    int32_t g0 = (int32_t)((c0 >> 8) & 0xFFu),  g1 = (int32_t)((c1 >> 8) & 0xFFu);
+    int32_t b0 = (int32_t)(c0 & 0xFFu),         b1 = (int32_t)(c1 & 0xFFu);
+    int32_t den = (n > 1) ? (n - 1) : 1;
+    l->r = (r0 << 16) + 0x8000; l->dr = ((r1 - r0) * 65536) / den;
+    l->g = (g0 << 16) + 0x8000; l->dg = ((g1 - g0) * 65536) / den;
+    l->b = (b0 << 16) + 0x8000; l->db = ((b1 - b0) * 65536) / den;
+}
+
+static inline uint32_t lerp_next(lerp_t* l) {
+    uint32_t c = ((uint32_t)(l->r >> 16) << 16) | ((uint32_t)(l->g >> 16) << 8) | (uint32_t)(l->b >> 16);
+    l->r += l->dr; l->g += l->dg; l->b += l->db;
+    return c;
+}
+
+void gfx_gradient_h(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t left, uint32_t right) {
+    int full_w = w, sx, sy;
+    if (!dst || !clip(dst, &x, &y, &w, &h, &sx, &sy)) return;
+
+    // Calcula a primeira linha uma vez e replica nas demais.
+    lerp_t l;
+    lerp_init(&l, left, right, full_w);
+    for (int i = 0; i < sx; i++) (void)lerp_next(&l);
+    uint32_t* first = row_at(dst, x, y);
+    for (int i = 0; i < w; i++) first[i] = lerp_next(&l);
+    for (int r = 1; r < h; r++) copy32(row_at(dst, x, y + r), first, w);
+}
+
+void gfx_gradient_v(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t top, uint32_t bottom) {
+    int full_h = h, sx, sy;
+    if (!dst || !clip(dst, &x, &y, &w, &h, &sx, &sy)) return;
+
+    lerp_t l;
+    lerp_init(&l, top, bottom, full_h);
+    for (int i = 0; i < sy; i++) (void)lerp_next(&l);
+    const gfx_span_ops_t* ops = simd_begin();
+    for (int r = 0; r < h; r++) ops->fill(row_at(dst, x, y + r), lerp_next(&l), w);
+    simd_end(ops);
+}
+
+void gfx_blit(gfx_surface_t* dst, int x, int y, const uint32_t* src, int sw, int sh, int src_stride) {
+    int sx, sy;
+    if (!dst || !src || !clip(dst, &x, &y, &sw, &sh, &sx, &sy)) return;
+    src += (uint32_t)sy * (uint32_t)src_stride + (uint32_t)sx;
+    for (int r = 0; r < sh; r++) copy32(row_at(dst, x, y + r), src + (uint32_t)r * (uint32_t)src_stride, sw);
+}
+
+void gfx_blit_alpha(gfx_surface_t* dst, int x, int y, const uint32_t* src, int sw, int sh, int src_stride) {
+    int sx, sy;
+    if (!dst || !src || !clip(dst, &x, &y, &sw, &sh, &sx, &sy)) return;
+    src += (uint32_t)sy * (uint32_t)src_stride + (uint32_t)sx;
+    const gfx_span_ops_t* ops = simd_begin();
+    for (int r = 0; r < sh; r++) ops->blend(row_at(dst, x, y + r), src + (uint32_t)r * (uint32_t)src_stride, sw);
+    simd_end(ops);
+}
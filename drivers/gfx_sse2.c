@@ -0,0 +1,143 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: gfx_sse2.c
+ * Descricao: Kernels de linha SSE2 para gfx.c (compilado com -msse2).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+
+// emmintrin.h puxa mm_malloc.h -> stdlib.h, que nao existe no kernel.
+#define _MM_MALLOC_H_INCLUDED
+#include <emmintrin.h>
+
+#include "gfx.h"
+
+// Este arquivo e o unico compilado com -msse2 (ver Makefile). So e chamado
+// quando cpu_select() confirmou SSE2 (fpu_init() ja ligou CR4.OSFXSR), e
+// sempre dentro de kernel_fpu_begin/end (ver gfx.c e video_vesa.c).
+
+static void sse2_fill(uint32_t* d, uint32_t color, int n) {
+    __m128i c = _mm_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128((__m128i*)(d + i), c);
+    for (; i < n; i++) d[i] = color;
+}
+
+// 4 pixels: t = s*a + d*(255-a) + 128 ; out = (t + (t >> 8)) >> 8
+// Mesma conta do caminho escalar (resultado identico).
+static inline __m128i blend4(__m128i s, __m128i d, __m128i zero, __m128i c255, __m128i c128) {
+    __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+    __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+    __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+    __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+
+    // Espalha o alpha de cada pixel nas 4 lanes de 16 bits dele
+    __m128i a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF);
+    __m128i a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF);
+    __m128i ia_lo = _mm_sub_epi16(c255, a_lo);
+    __m128i ia_hi = _mm_sub_epi16(c255, a_hi);
+
+    __m128i t_lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo), _mm_mullo_epi16(d_lo, ia_lo)), c128);
+    __m128i t_hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi), _mm_mullo_epi16(d_hi, ia_hi)), c128);
+    t_lo = _mm_srli_epi16(_mm_add_epi16(t_lo, _mm_srli_epi16(t_lo, 8)), 8);
+    t_hi = _mm_srli_epi16(_mm_add_epi16(t_hi, _mm_srli_epi16(t_hi, 8)), 8);
+
+    return _mm_packus_epi16(t_lo, t_hi);
+}
+
+static void sse2_blend(uint32_t* d, const uint32_t* s, int n) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i rgb  = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000u);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i sv = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i a = _mm_and_si128(sv, amask);
+        int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(a, amask));
+        if (opaque == 0xFFFF) {                     // 4 opacos: copia
+            _mm_storeu_si128((__m128i*)(d + i), _mm_and_si128(sv, rgb));
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xFFFF) continue;  // 4 transparentes
+
+        __m128i dv = _mm_loadu_si128((const __m128i*)(d + i));
+        _mm_storeu_si128((__m128i*)(d + i), _mm_and_si128(blend4(sv, dv, zero, c255, c128), rgb));
+    }
+
+    for (; i < n; i++) {
+        uint32_t a = s[i] >> 24, ia = 255u - a;
+        uint32_t rb = (s[i] & 0x00FF00FFu) * a + (d[i] & 0x00FF00FFu) * ia + 0x00800080u;
+        uint32_t g  = (s[i] & 0x0000FF00u) * a + (d[i] & 0x0000FF00u) * ia + 0x00008000u;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        g  = ((g  + ((g  >> 8) & 0x0000FF00u)) >> 8) & 0x0000FF00u;
+        d[i] = rb | g;
+    }
+}
+
+static void sse2_blend_const(uint32_t* d, uint32_t argb, int n) {
+    uint32_t a = argb >> 24;
+    if (a == 0) return;
+    if (a == 0xFFu) { sse2_fill(d, argb & 0x00FFFFFFu, n); return; }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgb  = _mm_set1_epi32(0x00FFFFFF);
+
+    // s*a + 128 e (255-a) sao constantes: so falta d*(255-a).
+    __m128i s16 = _mm_unpacklo_epi8(_mm_set1_epi32((int)argb), zero);
+    __m128i sa  = _mm_add_epi16(_mm_mullo_epi16(s16, _mm_set1_epi16((short)a)), _mm_set1_epi16(128));
+    __m128i ia  = _mm_set1_epi16((short)(255u - a));
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i dv = _mm_loadu_si128((const __m128i*)(d + i));
+        __m128i t_lo = _mm_add_epi16(sa, _mm_mullo_epi16(_mm_unpacklo_epi8(dv, zero), ia));
+        __m128i t_hi = _mm_add_epi16(sa, _mm_mullo_epi16(_mm_unpackhi_epi8(dv, zero), ia));
+        t_lo = _mm_srli_epi16(_mm_add_epi16(t_lo, _mm_srli_epi16(t_lo, 8)), 8);
+        t_hi = _mm_srli_epi16(_mm_add_epi16(t_hi, _mm_srli_epi16(t_hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(d + i), _mm_and_si128(_mm_packus_epi16(t_lo, t_hi), rgb));
+    }
+
+    uint32_t ia32 = 255u - a;
+    uint32_t srb = (argb & 0x00FF00FFu) * a + 0x00800080u;
+    uint32_t sg  = (argb & 0x0000FF00u) * a + 0x00008000u;
+    for (; i < n; i++) {
+        uint32_t rb = srb + (d[i] & 0x00FF00FFu) * ia32;
+        uint32_t g  = sg  + (d[i] & 0x0000FF00u) * ia32;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+        g  = ((g  + ((g  >> 8) & 0x0000FF00u)) >> 8) & 0x0000FF00u;
+        d[i] = rb | g;
+    }
+}
+
+// Copia para a VRAM com stores nao temporais de 16 bytes: em framebuffer
+// uncacheable e 1 escrita no barramento a cada 4 pixels (rep movsl faz 4), e
+// em write-combining nao polui o cache com a linha que nunca sera lida.
+void gfx_sse2_stream32(void* dst, const uint32_t* src, uint32_t n) {
+    uint32_t* d = (uint32_t*)dst;
+    uint32_t i = 0;
+    while (i < n && ((uintptr_t)(d + i) & 15u)) { d[i] = src[i]; i++; }
+    for (; i + 4 <= n; i += 4) {
+        _mm_stream_si128((__m128i*)(d + i), _mm_loadu_si128((const __m128i*)(src + i)));
+    }
+    for (; i < n; i++) d[i] = src[i];
+    _mm_sfence();
+}
+
+const gfx_span_ops_t gfx_sse2_ops = {
+    .fill        = sse2_fill,
+    .blend       = sse2_blend,
+    .blend_const = sse2_blend_const,
+};
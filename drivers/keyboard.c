@@ -16,10 +16,10 @@
 
 #include <stdint.h>
 #include "io.h"
-#include "pic.h"
 #include "irq.h"
 #include "isr.h"
 #include "keyboard.h"
+#include "event.h"
 
 #define KBD_DATA_PORT 0x60
 
@@ -162,6 +162,7 @@ static void keyboard_irq(regs_t *r) {
     }
 
     buf_push(ch);
+    event_post_key(ch);
 }
 
 void keyboard_init(void) {
@@ -172,5 +173,5 @@ void keyboard_init(void) {
 
     /* Install IRQ1 handler and unmask keyboard IRQ */
     irq_install_handler(1, keyboard_irq);
-    pic_unmask_irq(1);
+    irq_unmask(1);
 }
@@ -17,8 +17,8 @@
 #include <stdint.h>
 #include "io.h"
 #include "irq.h"
-#include "pic.h"
 #include "mouse.h"
+#include "event.h"
 
 // PS/2 controller ports
 #define PS2_DATA   0x60
@@ -147,6 +147,7 @@ static void mouse_irq(regs_t *r) {
     g_state.buttons = buttons;
 
     g_dirty = 1;
+    event_post_mouse(new_x, new_y, dx, -dy, buttons);
 }
 
 void mouse_set_bounds(int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y) {
@@ -220,6 +221,6 @@ void mouse_init(void) {
     irq_install_handler(12, mouse_irq);
 
     // IMPORTANT: IRQ12 is on the slave PIC, so master IRQ2 (cascade) must be unmasked.
-    pic_unmask_irq(2);
-    pic_unmask_irq(12);
+    irq_unmask(2);
+    irq_unmask(12);
 }
@@ -1,7 +1,7 @@
 /****************************************************************************
  * Projeto: Tervia Cinser OS
  * Arquivo: vga.c
- * Descrição: Núcleo do sistema operacional / Gerenciamento de processos.
+ * Descrição: Console em modo texto VGA (0xB8000) com scroll por hardware.
  * * Copyright (C) 2026 Tervia Corporation.
  *
  * Este programa é um software livre: você pode redistribuí-lo e/ou 
@@ -14,104 +14,168 @@
  * Licença Pública Geral GNU para mais detalhes.
  ****************************************************************************/
 
-#include "vga.h"
-
-#define VGA_WIDTH  80
-#define VGA_HEIGHT 25
-
-static volatile uint16_t *const VGA_MEM = (uint16_t *)0xB8000;
-
-static uint8_t cursor_x = 0;
-static uint8_t cursor_y = 0;
-static uint8_t vga_color = (VGA_COLOR_LIGHT_GREY | (VGA_COLOR_BLACK << 4));
 
-static inline uint16_t vga_entry(char ch, uint8_t color) {
-    return (uint16_t)ch | ((uint16_t)color << 8);
+#include <stdint.h>
+#include "vga.h"
+#include "io.h"
+
+// ---------------------------------------------------------------------------
+// Modo texto 80x25 (o que o GRUB deixa quando nao ha framebuffer linear).
+//
+// A janela de texto ocupa 32KB (0xB8000..0xBFFFF) = 16384 celulas, mas so
+// 80x25 sao visiveis. O scroll so avanca o "start address" do CRTC em uma
+// linha; quando a janela chega no fim do buffer, as linhas visiveis voltam
+// para o inicio (1 copia a cada ~180 linhas em vez de 1 por linha).
+// ---------------------------------------------------------------------------
+
+#define VGA_MEM_BASE   0xB8000u
+#define VGA_MEM_CELLS  16384u      // 32KB / 2
+
+#define CRTC_INDEX     0x3D4
+#define CRTC_DATA      0x3D5
+#define CRTC_CUR_START 0x0A
+#define CRTC_CUR_END   0x0B
+#define CRTC_START_HI  0x0C
+#define CRTC_START_LO  0x0D
+#define CRTC_CUR_HI    0x0E
+#define CRTC_CUR_LO    0x0F
+
+// Ultima linha fisica em que a janela visivel ainda cabe
+#define VGA_BUF_ROWS   (VGA_MEM_CELLS / VGA_TEXT_COLS)
+#define VGA_TOP_MAX    (VGA_BUF_ROWS - VGA_TEXT_ROWS)
+
+static volatile uint16_t* const g_mem = (volatile uint16_t*)VGA_MEM_BASE;
+
+static uint32_t g_top = 0;          // linha fisica mostrada no topo
+static int g_col = 0, g_row = 0;    // cursor (relativo a janela visivel)
+static uint16_t g_attr = 0x0700;    // cinza claro no preto, ja deslocado
+static uint16_t g_hw_start = 0xFFFF;
+static uint16_t g_hw_cursor = 0xFFFF;
+
+static inline void crtc_write(uint8_t reg, uint8_t v) {
+    outb(CRTC_INDEX, reg);
+    outb(CRTC_DATA, v);
 }
 
-void vga_set_color(vga_color_t fg, vga_color_t bg) {
-    vga_color = (uint8_t)fg | ((uint8_t)bg << 4);
+static inline volatile uint16_t* row_ptr(int row) {
+    return g_mem + (g_top + (uint32_t)row) * VGA_TEXT_COLS;
 }
 
-static void vga_clear_line(uint16_t y) {
-    for (uint16_t x = 0; x < VGA_WIDTH; x++) {
-        VGA_MEM[y * VGA_WIDTH + x] = vga_entry(' ', vga_color);
-    }
+static void fill_cells(volatile uint16_t* p, uint16_t cell, int n) {
+    // 2 celulas por escrita de 32 bits
+    uint32_t pair = (uint32_t)cell | ((uint32_t)cell << 16);
+    volatile uint32_t* q = (volatile uint32_t*)p;
+    int i = 0;
+    for (; i + 2 <= n; i += 2) *q++ = pair;
+    if (i < n) p[i] = cell;
 }
 
-void vga_clear(void) {
-    for (uint16_t y = 0; y < VGA_HEIGHT; y++) {
-        vga_clear_line(y);
-    }
-    cursor_x = 0;
-    cursor_y = 0;
+// So toca no CRTC quando o valor muda (cada registro sao 2 outb lentos).
+static void sync_start(void) {
+    uint16_t start = (uint16_t)(g_top * VGA_TEXT_COLS);
+    if (start == g_hw_start) return;
+    crtc_write(CRTC_START_HI, (uint8_t)(start >> 8));
+    crtc_write(CRTC_START_LO, (uint8_t)(start & 0xFF));
+    g_hw_start = start;
 }
 
-static void vga_scroll(void) {
-    // Move linhas 1..24 para 0..23
-    for (uint16_t y = 1; y < VGA_HEIGHT; y++) {
-        for (uint16_t x = 0; x < VGA_WIDTH; x++) {
-            VGA_MEM[(y - 1) * VGA_WIDTH + x] = VGA_MEM[y * VGA_WIDTH + x];
-        }
-    }
-
-    // Limpa a ultima linha
-    vga_clear_line(VGA_HEIGHT - 1);
-
-    cursor_y = VGA_HEIGHT - 1;
-    cursor_x = 0;
+static void sync_cursor(void) {
+    // O registro do cursor e absoluto no buffer (inclui o start address)
+    uint16_t pos = (uint16_t)((g_top + (uint32_t)g_row) * VGA_TEXT_COLS + (uint32_t)g_col);
+    if (pos == g_hw_cursor) return;
+    crtc_write(CRTC_CUR_HI, (uint8_t)(pos >> 8));
+    crtc_write(CRTC_CUR_LO, (uint8_t)(pos & 0xFF));
+    g_hw_cursor = pos;
 }
 
-static void vga_newline(void) {
-    cursor_x = 0;
-    if (cursor_y < VGA_HEIGHT - 1) {
-        cursor_y++;
+static void scroll_up(void) {
+    if (g_top < VGA_TOP_MAX) {
+        g_top++;
     } else {
-        // Scroll automatico quando chega no final
-        vga_scroll();
+        // Fim do buffer: traz as linhas visiveis (menos a primeira) para o inicio
+        volatile uint32_t* d = (volatile uint32_t*)g_mem;
+        volatile uint32_t* s = (volatile uint32_t*)row_ptr(1);
+        for (uint32_t i = 0; i < (VGA_TEXT_ROWS - 1) * VGA_TEXT_COLS / 2; i++) d[i] = s[i];
+        g_top = 0;
     }
+    fill_cells(row_ptr(VGA_TEXT_ROWS - 1), (uint16_t)(g_attr | ' '), VGA_TEXT_COLS);
+    sync_start();
 }
 
-void vga_putc(char c) {
-    if (c == '\n') {
-        vga_newline();
-        return;
-    }
+static void newline(void) {
+    g_col = 0;
+    if (g_row < VGA_TEXT_ROWS - 1) g_row++;
+    else scroll_up();
+}
 
-    if (c == '\r') {
-        // Carriage return: volta pro inicio da linha atual
-        cursor_x = 0;
-        return;
-    }
+static void put_raw(char c) {
+    if (c == '\n') { newline(); return; }
+    if (c == '\r') { g_col = 0; return; }
 
+    // Backspace: so move o cursor (apagar e responsabilidade do chamador,
+    // igual ao console em framebuffer)
     if (c == '\b') {
-        // Backspace simples (opcional, mas ajuda no terminal)
-        if (cursor_x > 0) {
-            cursor_x--;
-            VGA_MEM[cursor_y * VGA_WIDTH + cursor_x] = vga_entry(' ', vga_color);
+        if (g_col > 0) {
+            g_col--;
+        } else if (g_row > 0) {
+            g_row--;
+            g_col = VGA_TEXT_COLS - 1;
         }
         return;
     }
 
-    // Caracteres nao imprimiveis: ignora
-    if ((unsigned char)c < 0x20) {
-        return;
-    }
+    unsigned char uc = (unsigned char)c;
+    if (uc < 0x20) return;
+    if (uc > 0x7E) uc = ' ';
 
-    VGA_MEM[cursor_y * VGA_WIDTH + cursor_x] = vga_entry(c, vga_color);
+    row_ptr(g_row)[g_col] = (uint16_t)(g_attr | uc);
+    if (++g_col >= VGA_TEXT_COLS) newline();
+}
 
-    cursor_x++;
-    if (cursor_x >= VGA_WIDTH) {
-        vga_newline();
-    }
+void vgatext_set_color(uint8_t fg, uint8_t bg) {
+    g_attr = (uint16_t)(((bg & 0x0F) << 4 | (fg & 0x0F)) << 8);
+}
+
+void vgatext_clear(void) {
+    g_top = 0;
+    g_col = g_row = 0;
+    fill_cells(g_mem, (uint16_t)(g_attr | ' '), VGA_TEXT_ROWS * VGA_TEXT_COLS);
+    sync_start();
+    sync_cursor();
 }
 
-void vga_write(const char *s) {
+void vgatext_putc(char c) {
+    put_raw(c);
+    sync_cursor();
+}
+
+void vgatext_write(const char* s) {
     if (!s) return;
-    while (*s) vga_putc(*s++);
+    while (*s) put_raw(*s++);
+    sync_cursor();
+}
+
+void vgatext_set_cursor(int col, int row) {
+    if (col < 0) col = 0;
+    if (row < 0) row = 0;
+    if (col >= VGA_TEXT_COLS) col = VGA_TEXT_COLS - 1;
+    if (row >= VGA_TEXT_ROWS) row = VGA_TEXT_ROWS - 1;
+    g_col = col;
+    g_row = row;
+    sync_cursor();
 }
 
-void vga_init(void) {
-    vga_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
-    vga_clear();
+void vgatext_get_cursor(int* col, int* row) {
+    if (col) *col = g_col;
+    if (row) *row = g_row;
+}
+
+void vgatext_init(void) {
+    // Cursor em sublinhado (scanlines 14..15), visivel
+    crtc_write(CRTC_CUR_START, 14);
+    crtc_write(CRTC_CUR_END, 15);
+
+    g_hw_start = g_hw_cursor = 0xFFFF;
+    vgatext_set_color(0x07, 0x00);
+    vgatext_clear();
 }
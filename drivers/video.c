@@ -27,7 +27,7 @@ void video_init_system(void* mb_ptr) {
     multiboot_info_t* mbi = (multiboot_info_t*)mb_ptr;
 
     // Estrutura pensada para futuramente trocar por drivers externos (Intel iGPU, etc).
-    // Por enquanto, só ativamos VESA quando for seguro (RGB + 32bpp).
+    // Por enquanto, só ativamos VESA quando for seguro (RGB direto, 15/16/24/32bpp).
     if (!mbi) return;
 
     // Multiboot v1: bit 12 => framebuffer info válido
@@ -40,8 +40,10 @@ void video_init_system(void* mb_ptr) {
         return;
     }
 
-    // Nosso driver assume 32bpp (uint32_t por pixel). Se não for, não ativa.
-    if (mbi->framebuffer_bpp != 32) {
+    // O driver desenha sempre em 32bpp e converte no present.
+    // Formatos fora dessa lista não ativam o VESA.
+    uint8_t bpp = mbi->framebuffer_bpp;
+    if (bpp != 15 && bpp != 16 && bpp != 24 && bpp != 32) {
         return;
     }
 
@@ -69,3 +71,83 @@ void draw_rect(int x, int y, int w, int h, uint32_t color) {
         }
     }
 }
+
+// Copia um bloco de pixels (ex: superficie de janela) para a tela.
+void draw_blit(int x, int y, int w, int h, const uint32_t* src, int src_stride) {
+    if (!src || w <= 0 || h <= 0) return;
+    if (g_video_driver && g_video_driver->blit) {
+        g_video_driver->blit(x, y, w, h, src, src_stride);
+        return;
+    }
+
+    for (int i = 0; i < h; i++) {
+        const uint32_t* row = src + (uint32_t)i * (uint32_t)src_stride;
+        for (int j = 0; j < w; j++) {
+            put_pixel(x + j, y + i, row[j]);
+        }
+    }
+}
+
+// Copia tela->tela. Sem acelerador nao da para ler a tela: retorna 0.
+int video_copy_rect(int sx, int sy, int w, int h, int dx, int dy) {
+    if (g_video_driver && g_video_driver->copy_rect) {
+        return g_video_driver->copy_rect(sx, sy, w, h, dx, dy);
+    }
+    return 0;
+}
+
+// =============================
+// Cursor do mouse
+// =============================
+
+// Seta padrao: 'X' = contorno preto, '.' = miolo branco, ' ' = transparente.
+static const char* k_arrow[19] = {
+    "X           ",
+    "XX          ",
+    "X.X         ",
+    "X..X        ",
+    "X...X       ",
+    "X....X      ",
+    "X.....X     ",
+    "X......X    ",
+    "X.......X   ",
+    "X........X  ",
+    "X.........X ",
+    "X......XXXXX",
+    "X...X..X    ",
+    "X..XX..X    ",
+    "X.X  X..X   ",
+    "XX   X..X   ",
+    "X     X..X  ",
+    "      X..X  ",
+    "       XX   ",
+};
+
+void video_cursor_set(const uint32_t* img, int w, int h, int hot_x, int hot_y) {
+    if (g_video_driver && g_video_driver->cursor_set) {
+        g_video_driver->cursor_set(img, w, h, hot_x, hot_y);
+    }
+}
+
+void video_cursor_default(void) {
+    static uint32_t img[19 * 12];
+    for (int y = 0; y < 19; y++) {
+        for (int x = 0; x < 12; x++) {
+            char c = k_arrow[y][x];
+            img[y * 12 + x] = (c == 'X') ? 0xFF000000u : (c == '.') ? 0xFFFFFFFFu : 0u;
+        }
+    }
+    video_cursor_set(img, 12, 19, 0, 0);
+}
+
+void video_cursor_move(int x, int y) {
+    if (g_video_driver && g_video_driver->cursor_move) {
+        g_video_driver->cursor_move(x, y);
+    }
+}
+
+void video_cursor_show(int visible) {
+    if (g_video_driver && g_video_driver->cursor_show) {
+        g_video_driver->cursor_show(visible);
+    }
+}
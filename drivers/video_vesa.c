@@ -15,16 +15,29 @@
  ****************************************************************************/
 
 #include "video.h"
+#include "video_vesa.h"
 #include "multiboot.h"
+#include "irqstat.h"
+#include "cpu.h"
+#include "gfx.h"
+#include "fpu.h"
+#include "irqflags.h"
 #include <stdint.h>
 #include <stddef.h>
 
 // =============================
 // VESA OTIMIZADO & SEGURO (GCC Fix)
 // =============================
+//
+// O backbuffer e sempre 32bpp (0x00RRGGBB) em RAM. O formato real da VRAM
+// (16/24/32bpp, posicao dos canais) so importa no present: um kernel de
+// conversao especializado e escolhido UMA vez no init, a partir dos campos
+// de mascara de cor do Multiboot, e converte linhas inteiras de uma vez.
 
-static volatile uint32_t* g_vram = NULL;
-static uint32_t g_stride = 0; 
+static volatile uint8_t* g_vram = NULL;
+static uint32_t g_pitch = 0;       // bytes por scanline na VRAM
+static uint32_t g_bypp = 4;        // bytes por pixel na VRAM
+static uint32_t g_stride = 0;      // pixels por scanline no backbuffer
 static uint32_t* g_back = NULL;
 
 extern video_driver_t vesa_driver;
@@ -63,8 +76,246 @@ static inline void fast_memset32(void* dst, uint32_t val, uint32_t count) {
         : "memory", "cc"
     );
 }
+// Copia de tras para frente (std; rep movsl) para regioes sobrepostas.
+static inline void fast_memcpy32_rev(void* dst, const void* src, uint32_t count) {
+    if (!count) return;
+    int d0, d1, d2;
+    __asm__ volatile (
+        "std; rep movsl; cld"
+        : "=&D"(d0), "=&S"(d1), "=&c"(d2)
+        : "0"((uint32_t*)dst + count - 1), "1"((const uint32_t*)src + count - 1), "2"(count)
+        : "memory", "cc"
+    );
+}
 // ===================================
 
+// ---------------------------------------------------------------------------
+// Formato de pixel da VRAM + kernels de conversao
+// ---------------------------------------------------------------------------
+
+typedef void (*present_row_fn)(volatile uint8_t* dst, const uint32_t* src, uint32_t count);
+
+typedef struct {
+    uint8_t r_pos, r_size;
+    uint8_t g_pos, g_size;
+    uint8_t b_pos, b_size;
+} pixel_format_t;
+
+static pixel_format_t g_fmt;
+static present_row_fn g_present_row = NULL;
+static const char* g_present_name = "none";
+static int g_direct32 = 0;          // VRAM ja e 0x00RRGGBB: copia direta
+
+// Tabelas por canal: valor de 8 bits -> bits ja truncados e deslocados no
+// formato destino. Pixel final = lut_r[r] | lut_g[g] | lut_b[b].
+static uint32_t g_lut_r[256];
+static uint32_t g_lut_g[256];
+static uint32_t g_lut_b[256];
+
+static void lut_build(void) {
+    for (uint32_t v = 0; v < 256u; v++) {
+        g_lut_r[v] = (g_fmt.r_size ? (v >> (8u - g_fmt.r_size)) : 0u) << g_fmt.r_pos;
+        g_lut_g[v] = (g_fmt.g_size ? (v >> (8u - g_fmt.g_size)) : 0u) << g_fmt.g_pos;
+        g_lut_b[v] = (g_fmt.b_size ? (v >> (8u - g_fmt.b_size)) : 0u) << g_fmt.b_pos;
+    }
+}
+
+static inline uint32_t pack_lut(uint32_t p) {
+    return g_lut_r[(p >> 16) & 0xFFu] | g_lut_g[(p >> 8) & 0xFFu] | g_lut_b[p & 0xFFu];
+}
+
+static inline uint32_t pack_565(uint32_t p) {
+    return ((p >> 8) & 0xF800u) | ((p >> 5) & 0x07E0u) | ((p >> 3) & 0x001Fu);
+}
+
+static inline uint32_t pack_555(uint32_t p) {
+    return ((p >> 9) & 0x7C00u) | ((p >> 6) & 0x03E0u) | ((p >> 3) & 0x001Fu);
+}
+
+// 32bpp XRGB8888: o formato do backbuffer, copia direta.
+static void present_row_xrgb8888(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {
+    fast_memcpy32((void*)dst, src, count);
+}
+
+static void present_row_xrgb8888_nt(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {
+    gfx_sse2_stream32((void*)dst, src, count);
+}
+
+static const cpu_variant_t g_xrgb8888_variants[] = {
+    { CPU_F(CPU_SSE2) | CPU_F(CPU_FXSR), (const void*)present_row_xrgb8888_nt, "xrgb8888-nt" },
+    { 0,                                 (const void*)present_row_xrgb8888,    "xrgb8888"    },
+};
+
+// O present com stores nao temporais usa XMM: cada laco de linhas vira uma
+// regiao SIMD (pode ocorrer dentro de IRQ, por isso o aninhamento do fpu.c).
+// Sem nivel livre o laco usa a variante escalar.
+static int g_present_simd = 0;
+static present_row_fn g_present_row_scalar = NULL;
+
+static inline present_row_fn present_begin(void) {
+    if (!g_present_simd) return g_present_row;
+    if (!kernel_fpu_usable()) return g_present_row_scalar;
+    kernel_fpu_begin();
+    return g_present_row;
+}
+
+static inline void present_end(present_row_fn row) {
+    if (g_present_simd && row == g_present_row) kernel_fpu_end();
+}
+
+// 32bpp com canais em outra ordem (ex: BGRX).
+static void present_row_lut32(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {
+    volatile uint32_t* d = (volatile uint32_t*)dst;
+    for (uint32_t i = 0; i < count; i++) d[i] = pack_lut(src[i]);
+}
+
+static inline void put_rgb888(volatile uint8_t* b, uint32_t p) {
+    b[0] = (uint8_t)p;
+    b[1] = (uint8_t)(p >> 8);
+    b[2] = (uint8_t)(p >> 16);
+}
+
+// 24bpp RGB888 (bytes B,G,R): 4 pixels viram 3 dwords, sem escrita byte a byte.
+// Cada pixel anda 3 bytes, entao 0-3 pixels em bytes alinham o destino.
+static void present_row_rgb888(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {
+    uint32_t i = 0;
+    for (; i < count && ((uintptr_t)dst & 3u); i++, dst += 3) put_rgb888(dst, src[i]);
+
+    volatile uint32_t* d = (volatile uint32_t*)dst;
+    for (; i + 4u <= count; i += 4u) {
+        uint32_t p0 = src[i], p1 = src[i + 1], p2 = src[i + 2], p3 = src[i + 3];
+        d[0] = (p0 & 0x00FFFFFFu) | (p1 << 24);
+        d[1] = ((p1 >> 8) & 0x0000FFFFu) | (p2 << 16);
+        d[2] = ((p2 >> 16) & 0x000000FFu) | (p3 << 8);
+        d += 3;
+    }
+
+    volatile uint8_t* b = (volatile uint8_t*)d;
+    for (; i < count; i++, b += 3) put_rgb888(b, src[i]);
+}
+
+// 24bpp com canais em outra ordem.
+static void present_row_lut24(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t p = pack_lut(src[i]);
+        dst[0] = (uint8_t)p;
+        dst[1] = (uint8_t)(p >> 8);
+        dst[2] = (uint8_t)(p >> 16);
+        dst += 3;
+    }
+}
+
+// 16bpp: 2 pixels por store de 32 bits.
+#define DEFINE_PRESENT_ROW16(name, pack)                                              \
+static void name(volatile uint8_t* dst, const uint32_t* src, uint32_t count) {        \
+    uint32_t i = 0;                                                                   \
+    volatile uint16_t* d16 = (volatile uint16_t*)dst;                                 \
+    if (((uintptr_t)dst & 2u) && count) { d16[0] = (uint16_t)pack(src[0]); i = 1; }   \
+    volatile uint32_t* d32 = (volatile uint32_t*)(d16 + i);                           \
+    for (; i + 2u <= count; i += 2u) {                                                \
+        *d32++ = pack(src[i]) | (pack(src[i + 1]) << 16);                             \
+    }                                                                                 \
+    if (i < count) d16[i] = (uint16_t)pack(src[i]);                                   \
+}
+
+DEFINE_PRESENT_ROW16(present_row_rgb565, pack_565)
+DEFINE_PRESENT_ROW16(present_row_rgb555, pack_555)
+DEFINE_PRESENT_ROW16(present_row_lut16,  pack_lut)
+
+static int fmt_is(uint8_t rp, uint8_t rs, uint8_t gp, uint8_t gs, uint8_t bp, uint8_t bs) {
+    return g_fmt.r_pos == rp && g_fmt.r_size == rs &&
+           g_fmt.g_pos == gp && g_fmt.g_size == gs &&
+           g_fmt.b_pos == bp && g_fmt.b_size == bs;
+}
+
+// Escolhe o kernel de present. Retorna 0 se o formato nao e suportado.
+static int present_select(const multiboot_info_t* mbi) {
+    uint32_t bpp = mbi->framebuffer_bpp;
+
+    g_fmt.r_pos  = mbi->color_info.rgb.framebuffer_red_field_position;
+    g_fmt.r_size = mbi->color_info.rgb.framebuffer_red_mask_size;
+    g_fmt.g_pos  = mbi->color_info.rgb.framebuffer_green_field_position;
+    g_fmt.g_size = mbi->color_info.rgb.framebuffer_green_mask_size;
+    g_fmt.b_pos  = mbi->color_info.rgb.framebuffer_blue_field_position;
+    g_fmt.b_size = mbi->color_info.rgb.framebuffer_blue_mask_size;
+
+    // Alguns firmwares deixam as mascaras zeradas: assume o layout padrao.
+    if (g_fmt.r_size == 0 && g_fmt.g_size == 0 && g_fmt.b_size == 0) {
+        if (bpp == 16)      { g_fmt = (pixel_format_t){ 11, 5, 5, 6, 0, 5 }; }
+        else if (bpp == 15) { g_fmt = (pixel_format_t){ 10, 5, 5, 5, 0, 5 }; }
+        else                { g_fmt = (pixel_format_t){ 16, 8, 8, 8, 0, 8 }; }
+    }
+    if (g_fmt.r_size > 8 || g_fmt.g_size > 8 || g_fmt.b_size > 8) return 0;
+    lut_build();
+
+    if (bpp == 32) {
+        g_bypp = 4;
+        if (fmt_is(16, 8, 8, 8, 0, 8)) {
+            const cpu_variant_t* v = cpu_select(g_xrgb8888_variants, 2);
+            g_present_row = (present_row_fn)v->impl;
+            g_present_name = v->name;
+            g_present_simd = (v->impl == (const void*)present_row_xrgb8888_nt);
+            g_present_row_scalar = present_row_xrgb8888;
+            g_direct32 = 1;
+        } else {
+            g_present_row = present_row_lut32;
+            g_present_name = "lut32";
+        }
+        return 1;
+    }
+    if (bpp == 24) {
+        g_bypp = 3;
+        if (fmt_is(16, 8, 8, 8, 0, 8)) { g_present_row = present_row_rgb888; g_present_name = "rgb888"; }
+        else                           { g_present_row = present_row_lut24;  g_present_name = "lut24"; }
+        return 1;
+    }
+    if (bpp == 16 || bpp == 15) {
+        g_bypp = 2;
+        if (fmt_is(11, 5, 5, 6, 0, 5))      { g_present_row = present_row_rgb565; g_present_name = "rgb565"; }
+        else if (fmt_is(10, 5, 5, 5, 0, 5)) { g_present_row = present_row_rgb555; g_present_name = "rgb555"; }
+        else                                { g_present_row = present_row_lut16;  g_present_name = "lut16"; }
+        return 1;
+    }
+    return 0;
+}
+
+const char* vesa_present_kernel_name(void) {
+    return g_present_name;
+}
+
+// Converte um pixel de volta para 0x00RRGGBB (usado so na leitura da VRAM).
+static uint32_t unpack_pixel(uint32_t v) {
+    uint32_t r = (v >> g_fmt.r_pos) & ((1u << g_fmt.r_size) - 1u);
+    uint32_t g = (v >> g_fmt.g_pos) & ((1u << g_fmt.g_size) - 1u);
+    uint32_t b = (v >> g_fmt.b_pos) & ((1u << g_fmt.b_size) - 1u);
+    if (g_fmt.r_size) r = (r << (8u - g_fmt.r_size)) | (r >> (2u * g_fmt.r_size > 8u ? 2u * g_fmt.r_size - 8u : 0u));
+    if (g_fmt.g_size) g = (g << (8u - g_fmt.g_size)) | (g >> (2u * g_fmt.g_size > 8u ? 2u * g_fmt.g_size - 8u : 0u));
+    if (g_fmt.b_size) b = (b << (8u - g_fmt.b_size)) | (b >> (2u * g_fmt.b_size > 8u ? 2u * g_fmt.b_size - 8u : 0u));
+    return ((r & 0xFFu) << 16) | ((g & 0xFFu) << 8) | (b & 0xFFu);
+}
+
+static inline volatile uint8_t* vram_at(int x, int y) {
+    return g_vram + (uint32_t)y * g_pitch + (uint32_t)x * g_bypp;
+}
+
+// Escreve uma cor 32bpp direto na VRAM (caminho sem backbuffer).
+static void vram_write_span(int x, int y, int count, uint32_t color) {
+    if (g_direct32) {
+        fast_memset32((void*)vram_at(x, y), color, (uint32_t)count);
+        return;
+    }
+    uint32_t span[64];
+    for (int i = 0; i < 64; i++) span[i] = color;
+    while (count > 0) {
+        int n = count > 64 ? 64 : count;
+        g_present_row(vram_at(x, y), span, (uint32_t)n);
+        x += n;
+        count -= n;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 static void dirty_mark_rect(int x, int y, int w, int h) {
     if (vesa_driver.width <= 0 || vesa_driver.height <= 0) return;
     int x0 = clampi(x, 0, vesa_driver.width - 1);
@@ -83,11 +334,53 @@ static void dirty_mark_rect(int x, int y, int w, int h) {
     }
 }
 
+// O video sobe antes do heap (memory_init), entao o backbuffer e alocado de
+// forma preguicosa no primeiro update em que o kmalloc responder. O que ja foi
+// desenhado direto na VRAM e lido de volta uma unica vez, linha a linha com
+// loads de 32 bits (ler VRAM e lento; byte a byte seria 3-4x pior).
+static int vesa_try_alloc_back(void) {
+    if (g_back) return 1;
+    if (!g_vram || vesa_driver.width <= 0 || vesa_driver.height <= 0) return 0;
+
+    uint32_t total_pixels = g_stride * (uint32_t)vesa_driver.height;
+    uint32_t* p = (uint32_t*)kmalloc(total_pixels * 4);
+    if (!p) return 0;
+
+    for (int y = 0; y < vesa_driver.height; y++) {
+        uint32_t* row = p + (uint32_t)y * g_stride;
+        if (g_direct32) {
+            fast_memcpy32(row, (const void*)vram_at(0, y), (uint32_t)vesa_driver.width);
+            continue;
+        }
+        // Linha crua (width * bypp bytes) no comeco da linha do backbuffer...
+        uint32_t bytes = (uint32_t)vesa_driver.width * g_bypp;
+        volatile uint8_t* v = vram_at(0, y);
+        uint8_t* raw = (uint8_t*)row;
+        fast_memcpy32(raw, (const void*)v, bytes / 4u);
+        for (uint32_t i = bytes & ~3u; i < bytes; i++) raw[i] = v[i];
+        // ...e expande no lugar, do fim para o comeco (destino 4*x >= origem bypp*x)
+        for (int x = vesa_driver.width - 1; x >= 0; x--) {
+            const uint8_t* s = raw + (uint32_t)x * g_bypp;
+            uint32_t px = 0;
+            for (uint32_t i = 0; i < g_bypp; i++) px |= (uint32_t)s[i] << (8u * i);
+            row[x] = unpack_pixel(px);
+        }
+    }
+    g_back = p;
+    return 1;
+}
+
 static void vesa_init_impl(void* info);
 static void vesa_put_pixel(int x, int y, uint32_t color);
 static void vesa_fill_rect(int x, int y, int w, int h, uint32_t color);
 static void vesa_clear(uint32_t color);
 static void vesa_update(void);
+static void vesa_blit(int x, int y, int w, int h, const uint32_t* src, int src_stride);
+static int  vesa_copy_rect(int sx, int sy, int w, int h, int dx, int dy);
+static void vesa_cursor_set(const uint32_t* img, int w, int h, int hot_x, int hot_y);
+static void vesa_cursor_move(int x, int y);
+static void vesa_cursor_show(int visible);
+static void cursor_after_present(int x0, int y0, int x1, int y1);
 
 video_driver_t vesa_driver = {
     .driver_name   = "VESA Fixed",
@@ -99,26 +392,37 @@ video_driver_t vesa_driver = {
     .clear_screen  = vesa_clear,
     .update        = vesa_update,
     .fill_rect     = vesa_fill_rect,
+    .blit          = vesa_blit,
+    .copy_rect     = vesa_copy_rect,
+    .cursor_set    = vesa_cursor_set,
+    .cursor_move   = vesa_cursor_move,
+    .cursor_show   = vesa_cursor_show,
 };
 
 static void vesa_init_impl(void* info) {
     multiboot_info_t* mbi = (multiboot_info_t*)info;
-    if (!mbi || mbi->framebuffer_type != 1 || mbi->framebuffer_bpp != 32) return;
+    if (!mbi || mbi->framebuffer_type != 1) return;
+    if (!present_select(mbi)) return;
 
-    g_vram = (volatile uint32_t*)(uintptr_t)mbi->framebuffer_addr;
-    g_stride = mbi->framebuffer_pitch / 4; // Pitch em bytes -> Stride em pixels
+    g_vram = (volatile uint8_t*)(uintptr_t)mbi->framebuffer_addr;
+    g_pitch = mbi->framebuffer_pitch;
 
     vesa_driver.width  = (int)mbi->framebuffer_width;
     vesa_driver.height = (int)mbi->framebuffer_height;
     vesa_driver.bpp    = (int)mbi->framebuffer_bpp;
 
-    // Aloca Backbuffer
+    // Backbuffer e compacto (stride = largura), independente do pitch da VRAM.
+    g_stride = (uint32_t)vesa_driver.width;
+
+    // Aloca Backbuffer (normalmente falha aqui: o heap ainda nao existe)
     uint32_t total_pixels = g_stride * vesa_driver.height;
     g_back = (uint32_t*)kmalloc(total_pixels * 4);
     
     if (g_back) {
         // Limpa backbuffer com AZUL ESCURO para testar visualmente
         fast_memset32(g_back, 0x000000FF, total_pixels); 
+    } else {
+        vesa_fill_rect(0, 0, vesa_driver.width, vesa_driver.height, 0x00000000);
     }
 
     g_dirty = 1;
@@ -128,30 +432,18 @@ static void vesa_init_impl(void* info) {
     
     // O primeiro update limpa o "lixo" da tela
     vesa_update();
-	
-    if (!g_back) {
-        // SE APARECER UM QUADRADO VERMELHO NO CANTO, É FALTA DE RAM!
-        // Força desenho direto na VRAM para avisar erro
-        int stride = mbi->framebuffer_pitch / 4;
-        volatile uint32_t* vram = (volatile uint32_t*)(uintptr_t)mbi->framebuffer_addr;
-        for(int y=0; y<50; y++) {
-            for(int x=0; x<50; x++) {
-                vram[y*stride + x] = 0xFF0000; // Vermelho
-            }
-        }
-        return;
-    }
 }
 
 static void vesa_put_pixel(int x, int y, uint32_t color) {
     if (x < 0 || y < 0 || x >= vesa_driver.width || y >= vesa_driver.height) return;
-    uint32_t off = (uint32_t)y * g_stride + (uint32_t)x;
 
     if (g_back) {
-        g_back[off] = color;
+        g_back[(uint32_t)y * g_stride + (uint32_t)x] = color;
         dirty_mark_rect(x, y, 1, 1);
     } else if (g_vram) {
-        g_vram[off] = color;
+        present_row_fn present = present_begin();
+        present(vram_at(x, y), &color, 1);
+        present_end(present);
     }
 }
 
@@ -171,24 +463,201 @@ static void vesa_fill_rect(int x, int y, int w, int h, uint32_t color) {
         }
         dirty_mark_rect(x0, y0, rw, (y1 - y0) + 1);
     } 
-    // Fallback: desenha direto na VRAM
+    // Fallback: desenha direto na VRAM (já convertido para o formato dela)
     else if (g_vram) {
         for (int yy = y0; yy <= y1; yy++) {
-            // Cast removendo volatile para passar ao assembly (seguro aqui)
-            void* row = (void*)(g_vram + (uint32_t)yy * g_stride + (uint32_t)x0);
-            fast_memset32(row, color, rw);
+            vram_write_span(x0, yy, rw, color);
+        }
+    }
+}
+
+static void vesa_blit(int x, int y, int w, int h, const uint32_t* src, int src_stride) {
+    if (w <= 0 || h <= 0 || !src) return;
+
+    // Clipa e ajusta a origem da fonte junto.
+    if (x < 0) { src -= x; w += x; x = 0; }
+    if (y < 0) { src -= y * src_stride; h += y; y = 0; }
+    if (x + w > vesa_driver.width)  w = vesa_driver.width - x;
+    if (y + h > vesa_driver.height) h = vesa_driver.height - y;
+    if (w <= 0 || h <= 0) return;
+
+    if (g_back) {
+        for (int yy = 0; yy < h; yy++) {
+            uint32_t* row = g_back + (uint32_t)(y + yy) * g_stride + (uint32_t)x;
+            fast_memcpy32(row, src + yy * src_stride, (uint32_t)w);
+        }
+        dirty_mark_rect(x, y, w, h);
+    } else if (g_vram) {
+        present_row_fn present = present_begin();
+        for (int yy = 0; yy < h; yy++) {
+            present(vram_at(x, y + yy), src + yy * src_stride, (uint32_t)w);
         }
+        present_end(present);
+    }
+}
+
+// Move um bloco dentro do backbuffer (ex: arrastar janela). A origem e o
+// destino ja vem validos; so clipa contra a tela.
+static int vesa_copy_rect(int sx, int sy, int w, int h, int dx, int dy) {
+    if (!g_back) return 0;
+    if (w <= 0 || h <= 0) return 1;
+
+    // Clip (origem e destino juntos)
+    if (sx < 0) { w += sx; dx -= sx; sx = 0; }
+    if (sy < 0) { h += sy; dy -= sy; sy = 0; }
+    if (dx < 0) { w += dx; sx -= dx; dx = 0; }
+    if (dy < 0) { h += dy; sy -= dy; dy = 0; }
+    if (sx + w > vesa_driver.width)  w = vesa_driver.width - sx;
+    if (dx + w > vesa_driver.width)  w = vesa_driver.width - dx;
+    if (sy + h > vesa_driver.height) h = vesa_driver.height - sy;
+    if (dy + h > vesa_driver.height) h = vesa_driver.height - dy;
+    if (w <= 0 || h <= 0) return 1;
+
+    // Descendo: copia as linhas de baixo para cima. Mesma linha indo para a
+    // direita: copia cada linha de tras para frente.
+    int step = (dy > sy) ? -1 : 1;
+    int first = (step < 0) ? h - 1 : 0;
+    for (int i = 0, yy = first; i < h; i++, yy += step) {
+        uint32_t* d = g_back + (uint32_t)(dy + yy) * g_stride + (uint32_t)dx;
+        const uint32_t* src = g_back + (uint32_t)(sy + yy) * g_stride + (uint32_t)sx;
+        if (dy == sy && dx > sx) fast_memcpy32_rev(d, src, (uint32_t)w);
+        else fast_memcpy32(d, src, (uint32_t)w);
     }
+    dirty_mark_rect(dx, dy, w, h);
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// Cursor em overlay (save-under)
+// ---------------------------------------------------------------------------
+// O sprite existe so na VRAM; o backbuffer continua limpo. Mover o cursor
+// restaura o retangulo antigo a partir do save-under e salva/desenha o novo:
+// so esses dois retangulos tocam a VRAM, independente do que ha na tela.
+// Precisa do backbuffer (e dele que vem o "embaixo" do cursor).
+
+static uint32_t g_cur_img[VIDEO_CURSOR_MAX * VIDEO_CURSOR_MAX];
+static uint32_t g_cur_save[VIDEO_CURSOR_MAX * VIDEO_CURSOR_MAX];
+static int g_cur_w = 0, g_cur_h = 0, g_cur_hx = 0, g_cur_hy = 0;
+static int g_cur_x = 0, g_cur_y = 0;
+static int g_cur_visible = 0;
+
+// Retangulo (ja clipado) que esta desenhado na VRAM agora
+static int g_cur_drawn = 0;
+static int g_cur_sx = 0, g_cur_sy = 0, g_cur_sw = 0, g_cur_sh = 0;
+
+static inline uint32_t cursor_blend(uint32_t spr, uint32_t under) {
+    uint32_t a = spr >> 24;
+    if (a == 0xFFu) return spr & 0x00FFFFFFu;
+    if (a == 0) return under;
+    uint32_t rb = ((spr & 0x00FF00FFu) * a + (under & 0x00FF00FFu) * (255u - a)) >> 8;
+    uint32_t g  = ((spr & 0x0000FF00u) * a + (under & 0x0000FF00u) * (255u - a)) >> 8;
+    return (rb & 0x00FF00FFu) | (g & 0x0000FF00u);
+}
+
+static void cursor_erase(void) {
+    if (!g_cur_drawn) return;
+    present_row_fn present = present_begin();
+    for (int yy = 0; yy < g_cur_sh; yy++) {
+        present(vram_at(g_cur_sx, g_cur_sy + yy), g_cur_save + yy * VIDEO_CURSOR_MAX, (uint32_t)g_cur_sw);
+    }
+    present_end(present);
+    g_cur_drawn = 0;
+}
+
+static void cursor_paint(void) {
+    if (!g_cur_visible || !g_back || !g_vram || g_cur_w <= 0 || g_cur_h <= 0) return;
+
+    int ox = g_cur_x - g_cur_hx;
+    int oy = g_cur_y - g_cur_hy;
+    int x0 = clampi(ox, 0, vesa_driver.width);
+    int y0 = clampi(oy, 0, vesa_driver.height);
+    int x1 = clampi(ox + g_cur_w, 0, vesa_driver.width);
+    int y1 = clampi(oy + g_cur_h, 0, vesa_driver.height);
+    if (x1 <= x0 || y1 <= y0) return;
+
+    int n = x1 - x0;
+    uint32_t row[VIDEO_CURSOR_MAX];
+    present_row_fn present = present_begin();
+    for (int yy = y0; yy < y1; yy++) {
+        const uint32_t* under = g_back + (uint32_t)yy * g_stride + (uint32_t)x0;
+        const uint32_t* spr = g_cur_img + (yy - oy) * VIDEO_CURSOR_MAX + (x0 - ox);
+        uint32_t* save = g_cur_save + (yy - y0) * VIDEO_CURSOR_MAX;
+        for (int i = 0; i < n; i++) {
+            save[i] = under[i];
+            row[i] = cursor_blend(spr[i], under[i]);
+        }
+        present(vram_at(x0, yy), row, (uint32_t)n);
+    }
+    present_end(present);
+
+    g_cur_drawn = 1;
+    g_cur_sx = x0; g_cur_sy = y0;
+    g_cur_sw = n;  g_cur_sh = y1 - y0;
+}
+
+// Chamado com interrupcoes desligadas, logo apos o present de [x0..x1]x[y0..y1]:
+// se o present passou por cima do sprite, o save-under ficou velho.
+static void cursor_after_present(int x0, int y0, int x1, int y1) {
+    if (g_cur_drawn) {
+        if (x1 < g_cur_sx || x0 >= g_cur_sx + g_cur_sw ||
+            y1 < g_cur_sy || y0 >= g_cur_sy + g_cur_sh) return;
+        g_cur_drawn = 0;
+    }
+    cursor_paint();
+}
+
+static void vesa_cursor_set(const uint32_t* img, int w, int h, int hot_x, int hot_y) {
+    if (!img) return;
+    if (w > VIDEO_CURSOR_MAX) w = VIDEO_CURSOR_MAX;
+    if (h > VIDEO_CURSOR_MAX) h = VIDEO_CURSOR_MAX;
+
+    uint32_t flags = irq_save();
+    uint64_t off = irqoff_begin();
+    cursor_erase();
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) g_cur_img[y * VIDEO_CURSOR_MAX + x] = img[y * w + x];
+    }
+    g_cur_w = w; g_cur_h = h;
+    g_cur_hx = hot_x; g_cur_hy = hot_y;
+    cursor_paint();
+    irqoff_end("vesa_cursor_set", off);
+    irq_restore(flags);
+}
+
+static void vesa_cursor_move(int x, int y) {
+    if (x == g_cur_x && y == g_cur_y) return;
+    uint32_t flags = irq_save();
+    uint64_t off = irqoff_begin();
+    cursor_erase();
+    g_cur_x = x;
+    g_cur_y = y;
+    cursor_paint();
+    irqoff_end("vesa_cursor_move", off);
+    irq_restore(flags);
+}
+
+static void vesa_cursor_show(int visible) {
+    visible = visible ? 1 : 0;
+    if (visible == g_cur_visible) return;
+    uint32_t flags = irq_save();
+    uint64_t off = irqoff_begin();
+    cursor_erase();
+    g_cur_visible = visible;
+    cursor_paint();
+    irqoff_end("vesa_cursor_show", off);
+    irq_restore(flags);
 }
 
 static void vesa_clear(uint32_t color) {
     vesa_fill_rect(0, 0, vesa_driver.width, vesa_driver.height, color);
 }
 
-// ... (mantenha o resto do arquivo igual) ...
-
 static void vesa_update(void) {
-    if (!g_vram || !g_back || !g_dirty) return;
+    if (!g_vram) return;
+    if (!g_back) {
+        if (!vesa_try_alloc_back()) return;
+    }
+    if (!g_dirty) return;
 
     int x0 = clampi(g_minx, 0, vesa_driver.width - 1);
     int y0 = clampi(g_miny, 0, vesa_driver.height - 1);
@@ -200,20 +669,24 @@ static void vesa_update(void) {
     // Desativa interrupções para que o Timer ou Teclado não 
     // pausem a cópia no meio do desenho.
     __asm__ volatile("cli");
+    uint64_t off = irqoff_begin();
 
+    present_row_fn present = present_begin();
     for (int yy = y0; yy <= y1; yy++) {
-        uint32_t off = (uint32_t)yy * g_stride + (uint32_t)x0;
-        
-        void* dst = (void*)(g_vram + off);
-        const void* src = (const void*)(g_back + off);
-        
-        // Cópia ultra-rápida sem pausas
-        fast_memcpy32(dst, src, rw);
+        const uint32_t* src = g_back + (uint32_t)yy * g_stride + (uint32_t)x0;
+
+        // Kernel escolhido no init (copia direta ou conversao 16/24bpp)
+        present(vram_at(x0, yy), src, (uint32_t)rw);
     }
+    present_end(present);
+
+    // O present pode ter apagado o cursor: redesenha por cima se preciso.
+    cursor_after_present(x0, y0, x1, y1);
 
     // Reativa interrupções
+    irqoff_end("vesa_update", off);
     __asm__ volatile("sti");
     // ----------------------------------------------
 
     g_dirty = 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,49 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: acpi.h
+ * Descricao: Tabelas ACPI (RSDP/RSDT/XSDT)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cabecalho comum de toda tabela ACPI (SDT)
+typedef struct acpi_sdt {
+    char     sig[4];
+    uint32_t length;
+    uint8_t  revision;
+    uint8_t  checksum;
+    char     oem_id[6];
+    char     oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_sdt_t;
+
+// Procura o RSDP (EBDA e 0xE0000-0xFFFFF) e valida a RSDT/XSDT.
+// Retorna 0 se nao houver ACPI. Pode ser chamado mais de uma vez.
+int acpi_init(void);
+int acpi_present(void);
+uint8_t acpi_revision(void);
+
+// Primeira tabela com a assinatura pedida ("APIC", "HPET", ...) e checksum
+// valido, ou NULL. Sem paginacao: o ponteiro e o endereco fisico.
+const acpi_sdt_t* acpi_find_table(const char* sig);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: apic.h
+ * Descricao: Local APIC e I/O APIC (MADT, EOI, timer do LAPIC)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Vetor espurio do LAPIC: stub proprio (irq_spurious), sem EOI
+#define APIC_SPURIOUS_VECTOR 0xFF
+#define APIC_MAX_CPUS        16
+
+// Le a MADT (ACPI) e, se houver LAPIC + I/O APIC, liga o LAPIC e roteia as
+// IRQs ISA (0-15) para os mesmos vetores 0x20-0x2F, todas mascaradas. O 8259
+// fica mascarado. Sem MADT/APIC retorna 0 e nada muda (fica no 8259).
+// Chamar com IRQs desligadas e antes de time_init(): o timer do LAPIC e
+// calibrado no canal 2 do PIT (por polling) e registrado como tick; o
+// tick_init() de time_init() e que fixa a frequencia final.
+int apic_init(void);
+int apic_active(void);
+
+// EOI por MMIO (uma escrita, sem porta de I/O)
+void apic_eoi(void);
+uint8_t apic_id(void);
+
+// IRQ ISA -> entrada do I/O APIC (respeita os overrides da MADT)
+void apic_irq_mask(uint8_t irq);
+void apic_irq_unmask(uint8_t irq);
+
+// ICR: modo de entrega e nivel (IPIs entre CPUs, smp.c)
+#define APIC_ICR_FIXED   0x00000000u
+#define APIC_ICR_INIT    0x00000500u
+#define APIC_ICR_STARTUP 0x00000600u
+#define APIC_ICR_ASSERT  0x00004000u
+#define APIC_ICR_LEVEL   0x00008000u
+
+// Envia um IPI para o LAPIC 'dest' e espera a entrega. 0 = sem APIC/timeout.
+int apic_send_ipi(uint8_t dest, uint32_t icr);
+
+// Liga o LAPIC de um AP (roda no proprio AP, depois do apic_init no BSP)
+void apic_ap_init(void);
+
+// CPUs listadas na MADT (habilitadas)
+int apic_cpu_count(void);
+uint8_t apic_cpu_apic_id(int i);
+
+// Frequencia do timer do LAPIC (ja dividida), 0 se nao calibrou
+uint32_t apic_timer_hz(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,48 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: bootmod.h
+ * Descricao: Modulos multiboot carregados pelo GRUB (lista e busca por nome).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOTMOD_MAX      16
+#define BOOTMOD_CMDLINE  64
+
+typedef struct bootmod {
+    const uint8_t* data;            // identity-mapped, reservado pelo memory_init
+    uint32_t size;
+    char cmdline[BOOTMOD_CMDLINE];  // copia da linha do GRUB ("/boot/x.qoi wallpaper")
+} bootmod_t;
+
+// Copia a lista de modulos do Multiboot. Chamar depois de memory_init().
+void bootmod_init(uint32_t multiboot_magic, uint32_t mb_info_ptr);
+
+uint32_t bootmod_count(void);
+const bootmod_t* bootmod_get(uint32_t i);
+
+// Procura por nome: casa com qualquer palavra da linha de comando ou com o
+// nome do arquivo sem caminho/extensao ("wallpaper" acha /boot/wallpaper.qoi).
+const bootmod_t* bootmod_find(const char* name);
+
+// 1 se a linha de comando do modulo tem a palavra `arg`.
+int bootmod_has_arg(const bootmod_t* m, const char* arg);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: clock.h
+ * Descricao: Clocksources (TSC calibrado, ticks do PIT) e relogio monotonico.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fonte de tempo: contador livre e monotonico de frequencia conhecida.
+// O clock usa sempre a de maior rating; trocar de fonte nao faz o tempo
+// voltar (o valor atual vira a nova base).
+typedef struct clocksource {
+    const char* name;
+    uint64_t (*read)(void);
+    uint64_t freq_hz;
+    int rating;
+
+    // Preenchidos por clock_register(): ns = (ciclos * mult) >> shift
+    uint32_t mult;
+    uint32_t shift;
+    struct clocksource* next;
+} clocksource_t;
+
+#define CLOCK_RATING_JIFFIES 100
+#define CLOCK_RATING_TSC     250
+#define CLOCK_RATING_HPET    300    // estavel, mas cada leitura e MMIO
+#define CLOCK_RATING_TSC_INV 350    // TSC invariante (nao para em C-states/P-states)
+
+// Registra os ticks do timer (tick_hz) e, se houver TSC, calibra contra o
+// canal 2 do PIT. Chamado por time_init().
+void clock_init(uint32_t tick_hz);
+void clock_register(clocksource_t* cs);
+const char* clock_source_name(void);
+
+// 1 se a fonte ativa anda sozinha (nao depende do tick periodico). So
+// entao o timer pode ir para one-shot (tick.h).
+int clock_is_continuous(void);
+
+// Chamado a cada IRQ do timer periodico
+void clock_tick(void);
+uint64_t clock_jiffies(void);
+
+// Tempo desde o boot (fonte unica para ms/us/ns)
+uint64_t clock_ns(void);
+uint64_t clock_us(void);
+uint32_t clock_ms(void);
+
+// TSC bruto (para medir trechos curtos). Sem TSC, cai para clock_ns().
+uint64_t clock_cycles(void);
+uint64_t clock_cycles_to_ns(uint64_t cycles);
+uint64_t clock_tsc_hz(void);     // 0 = sem TSC ou calibracao falhou
+uint32_t clock_cpu_mhz(void);    // frequencia medida do TSC
+
+#ifdef __cplusplus
+}
+#endif
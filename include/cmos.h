@@ -23,4 +23,13 @@ typedef struct {
     uint16_t year; // 4-digit
 } rtc_time_t;
 
+// Full read: waits for the current update cycle (UIP) to end.
 void cmos_read_rtc(rtc_time_t *out);
+
+// Non-waiting read, meant for right after the update-ended IRQ8 (fields
+// stay stable for ~999ms). Returns 0 if an update was in progress.
+int cmos_read_rtc_now(rtc_time_t *out);
+
+// Update-ended interrupt (IRQ8, 1Hz) and its ack (reads register C).
+void cmos_rtc_irq_enable(void);
+uint8_t cmos_rtc_irq_ack(void);
@@ -0,0 +1,56 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: compositor.h
+ * Descricao: Compositor de camadas (superficies por janela + damage rects).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Uma camada = superficie 32bpp (0x00RRGGBB) posicionada na tela.
+// O dono (ex: window.c) desenha em `pixels` e avisa o compositor com
+// comp_layer_damage(); o compositor so copia para o backbuffer o que
+// estiver visivel e danificado.
+typedef struct comp_layer {
+    int x, y, w, h;
+    uint32_t* pixels;           // w*h pixels, stride = w
+    int visible;
+    int linked;                 // uso interno
+} comp_layer_t;
+
+// Pinta o fundo (desktop) numa area da tela ainda nao coberta por camadas.
+typedef void (*comp_background_fn)(int x, int y, int w, int h);
+
+void comp_set_background(comp_background_fn fn);
+
+// Entra no topo. -1 se ja ha COMP_MAX_LAYERS camadas (nao fica na tela).
+int  comp_layer_add(comp_layer_t* l);
+void comp_layer_remove(comp_layer_t* l);
+void comp_layer_raise(comp_layer_t* l);     // move para o topo
+void comp_layer_move(comp_layer_t* l, int x, int y);
+
+// Damage em coordenadas locais da camada / de tela.
+void comp_layer_damage(comp_layer_t* l, int x, int y, int w, int h);
+void comp_damage(int x, int y, int w, int h);
+void comp_damage_all(void);
+
+// Compoe as areas danificadas e faz o present. Sem damage = custo zero.
+void comp_compose(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -52,6 +52,11 @@ int console_get_rows(void);
 void console_set_cursor(int col, int row);
 void console_get_cursor(int* col, int* row);
 
+// Present adiado (shell): putc so marca a tela e a copia para a VRAM roda
+// como trabalho ocioso (idle.h), ou a cada 20ms sob saida continua.
+// 0 desliga e descarrega o que estiver pendente (ex: antes de travar).
+void console_defer_present(int on);
+
 void print_u64(uint64_t x);
 
 void print_int(int v);
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: cpu.h
+ * Descricao: Registro de recursos da CPU (CPUID) e selecao de variantes
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Recursos lidos uma vez no boot (cpu_init). A ordem e a dos nomes em cpu.c.
+typedef enum {
+    // CPUID 1, EDX
+    CPU_FPU, CPU_VME, CPU_PSE, CPU_TSC, CPU_MSR, CPU_PAE, CPU_CX8, CPU_APIC,
+    CPU_SEP, CPU_MTRR, CPU_PGE, CPU_CMOV, CPU_PAT, CPU_CLFLUSH, CPU_MMX,
+    CPU_FXSR, CPU_SSE, CPU_SSE2, CPU_HTT,
+    // CPUID 1, ECX
+    CPU_SSE3, CPU_PCLMUL, CPU_MONITOR, CPU_SSSE3, CPU_FMA, CPU_CX16,
+    CPU_SSE41, CPU_SSE42, CPU_X2APIC, CPU_MOVBE, CPU_POPCNT, CPU_TSC_DEADLINE,
+    CPU_AES, CPU_XSAVE, CPU_OSXSAVE, CPU_AVX, CPU_F16C, CPU_RDRAND,
+    CPU_HYPERVISOR,
+    // CPUID 5 / 6
+    CPU_MWAIT_IRQ,      // MWAIT acorda com IRQ mascarada (ECX bit 1)
+    CPU_ARAT,           // timer do LAPIC nao para em C-states
+    // CPUID 7.0
+    CPU_FSGSBASE, CPU_BMI1, CPU_AVX2, CPU_SMEP, CPU_BMI2, CPU_ERMS,
+    CPU_RDSEED, CPU_ADX, CPU_SMAP, CPU_CLFLUSHOPT, CPU_SHA, CPU_FSRM,
+    // CPUID 0x80000001 / 0x80000007
+    CPU_SYSCALL, CPU_NX, CPU_RDTSCP, CPU_LM, CPU_LZCNT, CPU_INVTSC,
+
+    CPU_FEATURE_COUNT
+} cpu_feature_t;
+
+#define CPU_F(f) (1ull << (f))
+
+// So le as folhas do CPUID; quem liga o suporte do SO a SIMD (CR0/CR4) e o
+// fpu_init(). Chamar antes de qualquer driver (primeira coisa no kernel_main).
+void cpu_init(void);
+
+int cpu_has(cpu_feature_t f);
+const char* cpu_feature_name(cpu_feature_t f);
+const char* cpu_vendor(void);
+uint32_t cpu_family(void);
+uint32_t cpu_model(void);
+
+// Selecao em tempo de execucao: lista de variantes da melhor para a
+// generica (needs = 0). O chamador guarda o ponteiro devolvido no init.
+typedef struct {
+    uint64_t needs;         // CPU_F(...) | CPU_F(...): todos exigidos
+    const void* impl;
+    const char* name;
+} cpu_variant_t;
+
+const cpu_variant_t* cpu_select(const cpu_variant_t* list, int count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,19 +21,23 @@
   delay.h - simple sleep/delay utilities for Cinser
 
   How it works:
-    - delay_tick() MUST be called from your timer IRQ (IRQ0) handler.
-    - delay_init(tps) should be called after you initialize PIT/time with the same TPS.
+    - Waits are measured with clock_ns() (clock.h), the same monotonic
+      source used by time_get_ticks().
+    - delay_init(tps) should be called with the same TPS given to time_init(),
+      so delay_ticks() knows how long a tick is.
 
   Notes:
-    - delay_ticks()/delay_ms()/delay_time() require interrupts enabled (sti),
-      otherwise the CPU will halt forever because no IRQ wakes it.
+    - delay_ticks()/delay_ms()/delay_time() halt between checks and require
+      interrupts enabled (sti), otherwise nothing wakes the CPU.
+    - delay_us() busy-waits and is safe with interrupts disabled.
 */
 
 void delay_init(uint32_t ticks_per_sec);
-void delay_tick(void);
 
+/* Milliseconds since boot, from the clocksource (like time_get_ticks()). */
 uint32_t delay_get_ticks(void);
 
 void delay_ticks(uint32_t ticks);
 void delay_time(uint32_t seconds);
 void delay_ms(uint32_t ms);
+void delay_us(uint32_t us);
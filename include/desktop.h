@@ -24,6 +24,8 @@ extern "C" {
 void desktop_init(void);
 void desktop_draw(void);
 void desktop_key(char c);
+int  desktop_mouse(int x, int y, uint8_t buttons);   // 1 = precisa redesenhar
+void desktop_run(void);                              // loop de eventos (nao retorna)
 
 #ifdef __cplusplus
 }
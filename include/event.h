@@ -0,0 +1,56 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: event.h
+ * Descricao: Fila de eventos do kernel (teclado, mouse, timer) alimentada pelas IRQs.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_NONE   0
+#define EVENT_KEY    1
+#define EVENT_MOUSE  2
+#define EVENT_TIMER  3
+
+typedef struct event {
+    uint8_t  type;      // EVENT_*
+    uint8_t  key;       // EVENT_KEY: caractere (mesmo valor do keyboard_getchar)
+    uint8_t  buttons;   // EVENT_MOUSE: bit0=L, bit1=R, bit2=M
+    uint8_t  _pad;
+    int32_t  x, y;      // EVENT_MOUSE: posicao absoluta
+    int32_t  dx, dy;    // EVENT_MOUSE: delta acumulado
+    uint32_t time;      // ticks (ms) em que o evento aconteceu
+} event_t;
+
+// Produtores (IRQs e callbacks de timer).
+void event_post_key(uint8_t ch);
+void event_post_mouse(int32_t x, int32_t y, int32_t dx, int32_t dy, uint8_t buttons);
+void event_post_timer(void);
+
+// Arma um EVENT_TIMER unico para quando time_get_ticks() chegar em `deadline`
+// (um timer da roda, timer.h). Se ja houver um armado, fica o mais cedo.
+// 0 = desarma.
+void event_timer_arm(uint32_t deadline);
+
+// Consumidor: retira o proximo evento. event_poll retorna 0 se a fila esta
+// vazia; event_wait dorme (cpu_idle) ate chegar algum.
+int  event_poll(event_t* out);
+void event_wait(event_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: fiber.h
+ * Descricao: Fibers cooperativas: varios fluxos com pilha propria dentro de um thread.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIBER_STACK_SIZE 8192
+
+// Cada thread (sched.h) tem seu anel de fibers; o fluxo original do thread
+// e a fiber raiz. So trocam de fiber em fiber_yield/fiber_wait, nunca numa
+// IRQ: entre essas chamadas o codigo roda sozinho dentro do thread. Nao
+// troque de fiber dentro de kernel_fpu_begin/end.
+
+// Evento de espera. 'pending' e levantado por fiber_signal (pode ser de IRQ
+// ou callback de timer); 'poll', se houver, e testado junto (IF=0) para
+// esperar por estado de driver sem mexer no driver (ex.: keyboard_haschar).
+typedef struct fiber_event {
+    volatile uint32_t pending;
+    int (*poll)(void);
+} fiber_event_t;
+
+#define FIBER_EVENT_INIT       { 0, 0 }
+#define FIBER_EVENT_POLL(fn)   { 0, (fn) }
+
+typedef struct fiber {
+    uint32_t* esp;                  // salvo por sched_switch
+    struct fiber* next;             // anel do thread
+    fiber_event_t* wait;            // esperando (0 = pronta)
+    void (*fn)(void* arg);
+    void* arg;
+    void* stack;                    // NULL na fiber raiz
+    const char* name;
+    uint32_t switches;
+} fiber_t;
+
+// Cria no anel do thread atual; so comeca a rodar quando a atual ceder.
+// Quando fn retorna a fiber acaba e a pilha volta para o heap.
+fiber_t* fiber_create(const char* name, void (*fn)(void* arg), void* arg);
+fiber_t* fiber_current(void);
+
+// Passa a vez para a proxima fiber pronta do anel (se nao houver, volta).
+void fiber_yield(void);
+
+// Roda as outras fibers ate 'ev' disparar; consome o disparo. Com todas
+// esperando, o thread dorme em cpu_idle() ate a proxima IRQ.
+void fiber_wait(fiber_event_t* ev);
+void fiber_signal(fiber_event_t* ev);
+
+// fiber_wait num evento disparado por um timer (timer.h).
+void fiber_sleep_ms(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
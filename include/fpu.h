@@ -0,0 +1,57 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: fpu.h
+ * Descricao: Estado x87/SSE: init, regioes SIMD do kernel e troca preguicosa (#NM).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Area do FXSAVE (512 bytes, alinhada em 16). 'used' = ja tem estado salvo;
+// um contexto novo recebe o estado limpo do boot no primeiro uso.
+typedef struct {
+    uint8_t  area[512] __attribute__((aligned(16)));
+    uint32_t used;
+} fpu_state_t;
+
+// Liga CR0.MP/NE, limpa CR0.EM e, com FXSR/SSE, CR4.OSFXSR/OSXMMEXCPT.
+// Depois de cpu_init() e antes de qualquer driver escolher variante SIMD.
+void fpu_init(void);
+int  fpu_present(void);
+
+// Troca de contexto (escalonador): so marca CR0.TS. O FXSAVE/FXRSTOR real
+// acontece no #NM, e so se o novo contexto usar a FPU.
+void fpu_state_init(fpu_state_t* st);
+void fpu_switch(fpu_state_t* next);
+
+// Chamado por isr_handler() no vetor 7. Retorna 1 se tratou.
+int fpu_handle_nm(void);
+
+// Regiao SIMD do kernel: os registradores viram rascunho entre begin/end.
+// Pode aninhar (ex: IRQ no meio de uma regiao), ate FPU_NEST_MAX niveis; o
+// nivel interrompido e salvo e restaurado. Nao troque de contexto dentro.
+// Alem de FPU_NEST_MAX o nivel interrompido nao e salvo: quem pode rodar
+// aninhado testa kernel_fpu_usable() antes e cai na variante escalar.
+#define FPU_NEST_MAX 4
+void kernel_fpu_begin(void);
+void kernel_fpu_end(void);
+int  kernel_fpu_usable(void);
+int  kernel_fpu_active(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,8 +18,8 @@
 
 /*
  * GDT + TSS
- * - GDT is defined/loaded in ASM (boot/boot_gdt.s)
- * - TR (TSS selector) is loaded in ASM (boot/boot_tss.s)
+ * - boot/boot.s loads a flat GDT (code=0x08, data=0x10) to reach kernel_main
+ * - kernel/tss.c then gives every CPU its own GDT + TSS (tss.h)
  * - We only expose a helper to set esp0/ss0 from C.
  */
 
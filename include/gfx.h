@@ -0,0 +1,64 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: gfx.h
+ * Descricao: Primitivas 2D (fill, blend, gradientes, blit com alpha) com SSE2.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Superficie 32bpp em RAM (backbuffer, superficie de janela, wallpaper...).
+// Destino: 0x00RRGGBB. Fontes com alpha: 0xAARRGGBB (AA=FF opaco).
+typedef struct gfx_surface {
+    uint32_t* pixels;
+    int w, h;
+    int stride;         // em pixels
+} gfx_surface_t;
+
+#define GFX_BACKEND_SCALAR 0
+#define GFX_BACKEND_SSE2   1
+
+// Detecta a CPU e escolhe o backend (chamar uma vez no boot).
+void gfx_init(void);
+int  gfx_backend(void);
+const char* gfx_backend_name(void);
+
+// Forca um backend (benchmark). Retorna 0 se nao suportado nesta CPU.
+int  gfx_set_backend(int backend);
+
+void gfx_fill(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t color);
+void gfx_blend_fill(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t argb);
+void gfx_gradient_h(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t left, uint32_t right);
+void gfx_gradient_v(gfx_surface_t* dst, int x, int y, int w, int h, uint32_t top, uint32_t bottom);
+void gfx_blit(gfx_surface_t* dst, int x, int y, const uint32_t* src, int sw, int sh, int src_stride);
+void gfx_blit_alpha(gfx_surface_t* dst, int x, int y, const uint32_t* src, int sw, int sh, int src_stride);
+
+// Kernels de linha (interno: gfx.c escolhe entre escalar e gfx_sse2.c)
+typedef struct gfx_span_ops {
+    void (*fill)(uint32_t* d, uint32_t color, int n);
+    void (*blend)(uint32_t* d, const uint32_t* s, int n);       // source-over por pixel
+    void (*blend_const)(uint32_t* d, uint32_t argb, int n);     // cor translucida
+} gfx_span_ops_t;
+
+extern const gfx_span_ops_t gfx_sse2_ops;
+
+// Present 32bpp com stores nao temporais (video_vesa.c, via cpu_select)
+void gfx_sse2_stream32(void* dst, const uint32_t* src, uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: hpet.h
+ * Descricao: HPET (clocksource e clockevent)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Localiza o HPET pela tabela ACPI "HPET", liga o contador principal e
+// registra um clocksource. Se o comparador 0 suportar modo periodico,
+// registra tambem um clockevent (IRQ0 pelo roteamento legado). Retorna 0
+// se nao houver HPET utilizavel. Chamado por time_init().
+int hpet_init(void);
+
+// Frequencia do contador principal (0 = sem HPET)
+uint64_t hpet_freq_hz(void);
+uint64_t hpet_read(void);
+
+// 1 enquanto o HPET e o tick no roteamento legado: o IRQ8 e do T1 e o RTC
+// nao interrompe (time.c passa a procurar a borda do RTC por polling).
+int hpet_owns_irq8(void);
+
+#ifdef __cplusplus
+}
+#endif
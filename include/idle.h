@@ -0,0 +1,65 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: idle.h
+ * Descricao: Laco ocioso central (MWAIT/HLT), trabalho em tempo ocioso e contabilidade.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Trabalho que so roda quando a CPU nao tem mais nada para fazer. fn
+// retorna 1 se fez algo (pode haver mais), 0 se nao havia nada.
+typedef struct idle_work {
+    const char* name;
+    int (*fn)(void* arg);
+    void* arg;
+    uint32_t runs;
+    struct idle_work* next;
+} idle_work_t;
+
+typedef struct {
+    uint32_t busy_pm;           // ocupacao no ultimo segundo (por mil)
+    uint32_t wakeups;           // saidas do halt no ultimo segundo
+    uint64_t idle_ns;           // ocioso desde idle_init()
+    uint64_t total_ns;          // tempo desde idle_init()
+    uint32_t wakeups_total;
+} idle_stats_t;
+
+// Depois do clocksource (time_init) e do cpu_init.
+void idle_init(void);
+
+// Unico ponto de espera do kernel. Chamar com IF=0 depois de testar a
+// condicao de espera; volta com IF=1. Roda softirqs pendentes, depois o
+// trabalho ocioso registrado e, se nada disso havia, dorme ate a proxima
+// interrupcao (MWAIT quando o CPUID anuncia, senao HLT). Com threads
+// (sched.h), fora do thread ocioso so bloqueia o thread ate a proxima IRQ.
+// Quem chama refaz o teste e chama de novo.
+void cpu_idle(void);
+
+void idle_register(idle_work_t* w);
+idle_work_t* idle_work_list(void);
+
+void idle_stats(idle_stats_t* out);
+
+// Escalonador, com IF=0: o thread ocioso saiu da CPU (talvez no meio do
+// halt, preemptado pela IRQ que o acordou). Fecha o intervalo ocioso.
+void idle_leave(void);
+const char* idle_method(void);
+
+#ifdef __cplusplus
+}
+#endif
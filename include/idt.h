@@ -19,3 +19,4 @@
 
 // Inicializa uma IDT minima (todas as entradas apontam para um handler que trava em HLT)
 void idt_init(void);
+void idt_load(void);
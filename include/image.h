@@ -0,0 +1,51 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: image.h
+ * Descricao: Decodificadores QOI/BMP em streaming (linha a linha) e escala.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMAGE_NONE  0
+#define IMAGE_QOI   1
+#define IMAGE_BMP   2
+
+#define IMAGE_SCALE_NEAREST   0
+#define IMAGE_SCALE_BILINEAR  1
+
+// Recebe cada linha decodificada, de cima para baixo (0x00RRGGBB).
+// `row` so e valido durante a chamada.
+typedef void (*image_row_fn)(void* ctx, int y, const uint32_t* row, int w);
+
+// Identifica o formato e le as dimensoes. Retorna IMAGE_* (NONE se invalido).
+int image_probe(const uint8_t* data, uint32_t len, int* w, int* h);
+
+// Decodifica linha a linha. `rowbuf` precisa ter `w` pixels.
+// Retorna 1 se a imagem inteira foi entregue.
+int image_decode(const uint8_t* data, uint32_t len, uint32_t* rowbuf,
+                 image_row_fn fn, void* ctx);
+
+// Decodifica escalando direto para `dst` (dst_w x dst_h, stride em pixels),
+// sem copia intermediaria da imagem inteira.
+int image_decode_scaled(const uint8_t* data, uint32_t len,
+                        uint32_t* dst, int dst_w, int dst_h, int dst_stride,
+                        int filter);
+
+#ifdef __cplusplus
+}
+#endif
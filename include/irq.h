@@ -24,12 +24,29 @@ extern "C" {
 
 typedef void (*irq_handler_t)(regs_t *r);
 
+// Handler encadeado para linhas compartilhadas (memoria do chamador)
+typedef struct irq_action {
+    irq_handler_t handler;
+    struct irq_action* next;
+} irq_action_t;
+
 void irq_init(void);
+// Handler unico da linha (substitui a cadeia inteira)
 void irq_install_handler(uint8_t irq, irq_handler_t handler);
 void irq_uninstall_handler(uint8_t irq);
+// Linha compartilhada: todos os handlers da cadeia rodam a cada IRQ
+void irq_add_handler(uint8_t irq, irq_action_t* action);
+void irq_remove_handler(uint8_t irq, irq_action_t* action);
+
+// Mascara/libera a linha no controlador ativo (8259 ou I/O APIC)
+void irq_mask(uint8_t irq);
+void irq_unmask(uint8_t irq);
 
-// Chamado pelos stubs de IRQ (int 0x20-0x2F)
+// Chamado pelos stubs de IRQ (int 0x20-0x2F): irq_dispatch no caminho
+// completo (vindo do ring 3); no caminho rapido o stub chama o handler do
+// vetor e depois irq_exit (EOI, estatistica, softirq).
 void irq_dispatch(regs_t *r);
+void irq_exit(regs_t *r);
 
 #ifdef __cplusplus
 }
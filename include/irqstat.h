@@ -0,0 +1,83 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: irqstat.h
+ * Descricao: Estatisticas de IRQ (contadores, histogramas, secoes com IRQs desligadas)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IRQSTAT_LINES   16
+// Histograma log2 em ciclos do TSC: balde 0 = < 128, balde k = [2^(k+6),
+// 2^(k+7)), o ultimo acumula tudo acima.
+#define IRQSTAT_BUCKETS 16
+#define IRQOFF_SITES    16
+
+typedef struct {
+    uint32_t count;
+    uint32_t max;               // ciclos
+    uint64_t total;             // ciclos
+    uint32_t hist[IRQSTAT_BUCKETS];
+} irqstat_hist_t;
+
+typedef struct {
+    const char* site;
+    uint32_t count;
+    uint32_t max;               // ciclos
+    uint64_t total;
+} irqoff_site_t;
+
+// Escritos pelo irq_common (boot/interrupts.s): TSC na entrada do stub (so
+// se irqstat_tsc != 0) e contagem do vetor espurio do LAPIC.
+// irq_entry_tsc e um so para todos os niveis: so vale enquanto IF=0. Com os
+// softirqs (IF=1) qualquer IRQ aninhado o sobrescreve, entao o C copia para
+// uma local antes de religar as interrupcoes.
+extern volatile uint64_t irq_entry_tsc;
+extern uint8_t irqstat_tsc;
+extern volatile uint32_t irqstat_spurious;
+
+// Liga a leitura do TSC se houver (depois do clock_init).
+void irqstat_init(void);
+
+static inline uint64_t irqstat_now(void) {
+    if (!irqstat_tsc) return 0;
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// irq_dispatch: entrada = stub -> dispatch, handler = so a chamada.
+void irqstat_record(uint8_t irq, uint64_t entry, uint64_t start, uint64_t end);
+
+uint32_t irqstat_count(uint8_t irq);
+const irqstat_hist_t* irqstat_handler(uint8_t irq);
+const irqstat_hist_t* irqstat_entry(uint8_t irq);
+void irqstat_reset(void);
+
+// Secoes com IRQs desligadas: t0 = irqoff_begin() logo depois do cli,
+// irqoff_end("local", t0) logo antes do sti. Guarda o pior caso por local.
+static inline uint64_t irqoff_begin(void) {
+    return irqstat_now();
+}
+void irqoff_end(const char* site, uint64_t t0);
+
+// Copia os locais ordenados pelo pior caso (maior primeiro).
+int irqoff_sites(irqoff_site_t* out, int max);
+
+#ifdef __cplusplus
+}
+#endif
@@ -93,6 +93,16 @@ static inline uint64_t div_ceil_u64(uint64_t a, uint64_t b) {
     return (a + b - 1ull) / b;
 }
 
+/* (a * mul) >> shift com produto intermediario de 96 bits, sem libgcc.
+ * Usado para converter ciclos -> ns com mult/shift pre-calculados. */
+static inline uint64_t mul_u64_u32_shr(uint64_t a, uint32_t mul, uint32_t shift) {
+    uint64_t lo = (uint64_t)(uint32_t)a * mul;
+    uint64_t hi = (uint64_t)(uint32_t)(a >> 32) * mul;
+    if (shift == 0) return lo + (hi << 32);
+    if (shift <= 32) return (lo >> shift) + (hi << (32 - shift));
+    return (hi + (lo >> 32)) >> (shift - 32);
+}
+
 /* -----------------------------
  * Comparacao segura para contadores que podem overflow (tick, etc.)
  * Retorna true se (now - deadline) >= 0 na aritmetica modular.
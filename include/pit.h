@@ -0,0 +1,46 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: pit.h
+ * Descricao: Programacao do PIT 8253/8254 (canal 0 = IRQ0, canal 2 = calibracao).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frequencia base do oscilador do PIT (1.193182 MHz)
+#define PIT_HZ 1193182u
+
+// Canal 0 em modo 3 (onda quadrada): IRQ0 a cada 1/hz segundos.
+void pit_set_periodic(uint32_t hz);
+
+// Canal 0 em modo 0: um unico IRQ0 daqui a delta_ns (limitado a
+// PIT_ONESHOT_MAX_NS, ~54.9ms = 65535 pulsos).
+#define PIT_ONESHOT_MAX_NS 54900000u
+#define PIT_ONESHOT_MIN_NS 20000u
+void pit_set_oneshot(uint32_t delta_ns);
+
+// Canal 0 parado (modo 0 sem contagem): nenhum IRQ0 ate o proximo set_*.
+void pit_stop(void);
+
+// Canal 2 (gate pela porta 0x61, sem alto-falante) em modo 0: conta 'count'
+// pulsos e levanta OUT2. Usado para medir intervalos sem depender de IRQ.
+void pit_ch2_start(uint16_t count);
+int  pit_ch2_expired(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: sched.h
+ * Descricao: Threads do kernel: escalonador round-robin preemptivo com prioridades.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include "fpu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHED_STACK_SIZE 16384
+#define SCHED_SLICE_MS   10         // fatia entre threads da mesma prioridade
+#define SCHED_NAME_MAX   16
+
+// Menor numero = mais prioritario. Um thread pronto de prioridade maior
+// que o atual preempta no proximo retorno de IRQ; na mesma prioridade a
+// CPU roda em round-robin a cada SCHED_SLICE_MS.
+enum {
+    SCHED_PRIO_HIGH = 0,
+    SCHED_PRIO_NORMAL,
+    SCHED_PRIO_LOW,
+    SCHED_PRIO_IDLE,                // so o thread ocioso
+    SCHED_PRIO_COUNT
+};
+
+enum {
+    THREAD_RUNNING = 0,
+    THREAD_READY,
+    THREAD_BLOCKED,
+    THREAD_DEAD
+};
+
+typedef struct thread {
+    uint32_t* esp;                  // salvo por sched_switch
+    struct thread* next;            // fila de prontos ou de espera
+    struct thread* all_next;        // todos os threads (ps)
+    uint32_t id;
+    char name[SCHED_NAME_MAX];
+    uint8_t prio;
+    uint8_t state;
+    void (*fn)(void* arg);
+    void* arg;
+    void* stack;                    // NULL no thread do boot
+    uint64_t runtime_ns;
+    uint32_t switches;
+    void* fibers;                   // anel de fibers (fiber.c), 0 = nenhuma
+    fpu_state_t fpu;
+} thread_t;
+
+// Fila de espera: threads bloqueados ate alguem chamar wake_up.
+typedef struct {
+    thread_t* head;
+    thread_t* tail;
+} wait_queue_t;
+
+#define WAIT_QUEUE_INIT { 0, 0 }
+
+// O fluxo do boot vira o thread "main" e nasce o thread ocioso. Depois do
+// heap, do fpu_init e do idle_init.
+void sched_init(void);
+int  sched_active(void);
+
+thread_t* thread_create(const char* name, void (*fn)(void* arg), void* arg, int prio);
+thread_t* sched_current(void);
+
+void sched_yield(void);
+void sched_exit(void) __attribute__((noreturn));
+void sched_sleep_ms(uint32_t ms);
+
+// Chamar com IF=0 depois de testar a condicao; volta com IF=1. Quem acorda
+// o thread so o coloca na fila: a condicao deve ser testada de novo.
+void sched_sleep_on(wait_queue_t* wq);
+void wake_up(wait_queue_t* wq);
+void wake_up_all(wait_queue_t* wq);
+
+// Sem troca de thread no trecho (IRQs continuam ligadas). Aninha.
+void preempt_disable(void);
+void preempt_enable(void);
+
+// cpu_idle() fora do thread ocioso: dorme ate a proxima IRQ deixando os
+// outros threads rodarem. Retorna 0 se nao ha escalonador (halt normal).
+int  sched_wait_irq(void);
+
+// Fim de irq_finish (IRQs desligadas): acorda quem esperava IRQ e troca de
+// thread se foi pedido e e seguro.
+void sched_irq_exit(void);
+
+typedef struct {
+    uint32_t id;
+    char name[SCHED_NAME_MAX];
+    uint8_t prio;
+    uint8_t state;
+    uint32_t runtime_ms;
+    uint32_t switches;
+} sched_info_t;
+
+int sched_snapshot(sched_info_t* out, int max);
+
+// Troca de pilha (IF=0): salva ebp/ebx/esi/edi e o esp em *save, retoma
+// 'next' no mesmo formato. Usada tambem pelas fibers (fiber.c).
+void sched_switch(uint32_t** save, uint32_t* next);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: smp.h
+ * Descricao: SMP: partida dos APs (INIT-SIPI-SIPI), dados por CPU e chamadas por IPI.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SMP_MAX_CPUS        16          // = APIC_MAX_CPUS / TSS_MAX_CPUS
+#define SMP_IPI_VECTOR      0xF0
+#define SMP_STACK_SIZE      16384
+#define SMP_TRAMPOLINE      0x7000u     // pagina baixa do codigo de partida (SIPI 0x07)
+
+typedef void (*smp_fn_t)(void* arg);
+
+// O kernel (threads, heap, console, timers) continua rodando so no BSP.
+// Os APs ficam no seu loop ocioso e so executam o que chega por smp_call:
+// funcoes que mexem apenas nos proprios dados (calculo em pedacos
+// disjuntos), sem kmalloc, console ou escalonador.
+
+// Com IRQs ligadas, depois do apic_init e do delay_init. Sem APIC ou com
+// uma CPU so fica tudo no BSP. Retorna quantas CPUs ficaram online.
+int smp_init(void);
+
+int smp_cpu_count(void);        // online, BSP incluso
+int smp_cpu_id(void);           // 0 = BSP; APs em ordem de partida
+
+// Roda fn(arg) na CPU 'cpu' (na propria, chama direto). wait=1 espera
+// terminar. -1 se a CPU nao esta online.
+int  smp_call(int cpu, smp_fn_t fn, void* arg, int wait);
+
+// Roda fn(arg) em todas as CPUs online, inclusive nesta, e espera todas.
+void smp_call_all(smp_fn_t fn, void* arg);
+
+typedef struct {
+    uint32_t index;
+    uint8_t  apic_id;
+    uint8_t  online;
+    uint32_t calls;             // chamadas executadas
+    uint32_t wakeups;           // saidas do hlt no loop ocioso
+    uint32_t idle_pm;           // ocioso desde que subiu (por mil), so APs
+} smp_info_t;
+
+int smp_snapshot(smp_info_t* out, int max);
+
+// IPI de chamada (boot/interrupts.s): so o EOI, quem roda e o loop ocioso
+void smp_ipi_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
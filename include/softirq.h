@@ -0,0 +1,70 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: softirq.h
+ * Descricao: Trabalho adiado de IRQ (softirqs e tasklets)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Softirqs: poucos tipos fixos, marcados por bit. Um handler de IRQ so marca
+// (softirq_raise) e sai; o trabalho roda no fim do irq_dispatch, depois do
+// EOI e com interrupcoes ligadas, ou no laco ocioso. Nunca reentra: uma IRQ
+// que chega no meio so marca mais bits, que entram na proxima volta.
+enum {
+    SOFTIRQ_TIMER = 0,      // roda de timers (timer.c)
+    SOFTIRQ_TASKLET,        // fila de tasklets
+    SOFTIRQ_COUNT
+};
+
+typedef void (*softirq_fn_t)(void);
+
+void softirq_init(void);
+void softirq_register(int nr, softirq_fn_t fn);
+
+// Qualquer contexto, sem lock (or atomico no pendente da CPU).
+void softirq_raise(int nr);
+int  softirq_pending(void);
+
+// Esvazia os pendentes com IRQs ligadas. No-op se ja estiver rodando.
+void softirq_run(void);
+// Fim do irq_dispatch (IRQs desligadas): roda os pendentes e volta com
+// IRQs desligadas.
+void softirq_irq_exit(void);
+
+// 1 enquanto softirq_run executa (o escalonador nao troca de thread aqui)
+int softirq_active(void);
+
+// Quantas vezes cada softirq rodou (diagnostico)
+uint32_t softirq_count(int nr);
+
+// Tasklet: callback avulso agendado por um handler de IRQ. Agendar de novo
+// antes de rodar nao duplica; pode se reagendar de dentro do callback.
+typedef struct tasklet {
+    struct tasklet* next;
+    void (*fn)(void* arg);
+    void* arg;
+    volatile uint32_t state;    // 1 = na fila
+} tasklet_t;
+
+#define TASKLET_INIT(f, a) { 0, (f), (a), 0 }
+
+void tasklet_schedule(tasklet_t* t);
+
+#ifdef __cplusplus
+}
+#endif
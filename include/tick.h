@@ -0,0 +1,66 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: tick.h
+ * Descricao: Timer de eventos do kernel: tick periodico ou one-shot (tickless).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dispositivo que gera o IRQ do timer (PIT no boot; o LAPIC, quando existe,
+// registra o seu com rating maior).
+typedef struct clockevent {
+    const char* name;
+    int rating;
+    uint32_t min_delta_ns;
+    uint32_t max_delta_ns;
+    void (*set_periodic)(uint32_t hz);
+    void (*set_oneshot)(uint32_t delta_ns);   // NULL = so periodico
+    void (*shutdown)(void);                   // para de gerar IRQs (troca)
+} clockevent_t;
+
+#define CLOCKEVENT_RATING_PIT   100
+#define CLOCKEVENT_RATING_HPET  150
+#define CLOCKEVENT_RATING_LAPIC 200             // por CPU, EOI/rearme por MMIO
+
+#define TICK_NEVER 0xFFFFFFFFFFFFFFFFull
+
+// Registra o PIT e liga o modo periodico em hz.
+void tick_init(uint32_t hz);
+// Retorna 1 se o dispositivo passou a ser o timer (rating maior).
+int tick_register(clockevent_t* ce);
+const char* tick_device_name(void);
+
+// Tickless: o timer so interrompe no proximo prazo pedido (ou a cada
+// max_delta_ns, no maximo). Retorna 0 se nao for possivel (sem one-shot ou
+// sem clocksource continuo). Passe 0 para voltar ao periodico.
+int  tick_set_nohz(int on);
+int  tick_is_nohz(void);
+
+// Garante um IRQ do timer ate 'deadline' (ns de clock_ns()). E so uma dica:
+// quem espera deve pedir de novo a cada volta do laco. No-op no periodico.
+void tick_wake_at(uint64_t deadline_ns);
+// Mesmo, com prazo em ms no dominio de time_get_ticks().
+void tick_wake_at_ms(uint32_t deadline_ms);
+
+// Fim do handler do timer: conta o IRQ e arma o proximo one-shot.
+void tick_irq_exit(void);
+uint32_t tick_irq_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -29,12 +29,16 @@ void time_init(uint32_t pit_ticks_per_sec);
 
 void time_tick(void);
 
-// Retorna o tempo atual (estrutura em RAM, atualizada pelo timer).
+// Segundos desde 1970-01-01 00:00 (hora do RTC, sem fuso): leitura do RTC
+// no boot + clocksource, realinhado pelo IRQ8 de fim de update do RTC.
+uint64_t time_epoch(void);
+
+// Data/hora civil de time_epoch(), convertida so quando o segundo muda.
 rtc_time_t time_now(void);
 
 // Retorna um ponteiro para uma string estatica formatada:
 // "HH:MM:SS DD/MM/YYYY"
-// A string so e atualizada quando o segundo muda (reduz trabalho/writes).
+// A string so e refeita quando pedida num segundo novo.
 const char *time_datetime_str(void);
 
 // Indica se a string formatada foi atualizada desde a ultima chamada
@@ -44,9 +48,8 @@ int time_has_update(void);
 // Marca a atualizacao como consumida.
 void time_consume_update(void);
 
-// Retorna o numero de ticks desde o boot.
-// O tick e incrementado pelo IRQ0 (PIT) em time_tick().
-// Se time_init(1000) for usado, 1 tick ~= 1ms.
+// Milissegundos desde o boot, lidos do clocksource ativo (clock.h).
+// Para resolucao abaixo de 1ms use clock_ns()/clock_cycles().
 uint32_t time_get_ticks(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,57 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: timer.h
+ * Descricao: Timers do kernel sobre uma roda hierarquica (insercao/expiracao O(1)).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Prazos em ms no dominio de time_get_ticks() (32 bits, com wrap).
+//
+// Callbacks rodam em contexto adiado (SOFTIRQ_TIMER): no fim do IRQ, depois
+// do EOI, com interrupcoes ligadas e sem reentrar. Devem ser curtos, nao podem dormir
+// nem escrever no console; para acordar a UI, poste um evento.
+
+typedef void (*timer_fn_t)(void* arg);
+typedef struct ktimer ktimer_t;
+
+#define TIMER_POOL_SIZE 64
+
+void timer_init(void);
+
+// One-shot: dispara quando time_get_ticks() chegar em deadline. O handle deixa
+// de valer depois que o callback roda. NULL se o pool acabou.
+ktimer_t* timer_add(uint32_t deadline, timer_fn_t cb, void* arg);
+
+// Periodico: primeiro disparo em first, depois a cada period_ms (sem deriva:
+// o proximo prazo soma ao anterior, nao ao instante em que rodou).
+ktimer_t* timer_add_periodic(uint32_t first, uint32_t period_ms, timer_fn_t cb, void* arg);
+
+// Retorna 1 se o timer estava pendente e foi removido.
+int timer_cancel(ktimer_t* t);
+
+// irq_dispatch marca SOFTIRQ_TIMER se ha timer vencido; timer_run executa.
+int  timer_due(uint32_t now);
+void timer_run(uint32_t now);
+
+// Proximo prazo conhecido (para o tickless). 0 = nenhum timer.
+int  timer_next_expiry(uint32_t* deadline);
+
+#ifdef __cplusplus
+}
+#endif
@@ -17,6 +17,11 @@
 #pragma once
 #include <stdint.h>
 
+#define TSS_MAX_CPUS  16
+#define GDT_KCODE_SEL 0x08
+#define GDT_KDATA_SEL 0x10
+#define GDT_TSS_SEL   0x18
+
 // Minimal 32-bit TSS (104 bytes)
 typedef struct __attribute__((packed)) tss_entry {
     uint32_t prev_tss;
@@ -37,7 +42,8 @@ typedef struct __attribute__((packed)) tss_entry {
     uint16_t iomap_base;
 } tss_entry_t;
 
-extern tss_entry_t tss;
-
-// Load TR (LTR) after IDT is ready
-void tss_load(void);
+// Per-CPU GDT (null, kernel code, kernel data, TSS) and TSS. Must run on the
+// CPU itself: loads GDTR, reloads the segment registers and loads TR. The
+// selectors are the same on every CPU, so the shared IDT works everywhere.
+void tss_cpu_init(int cpu, uint32_t stack_top);
+tss_entry_t* tss_cpu(int cpu);
@@ -1,7 +1,7 @@
 /****************************************************************************
  * Projeto: Tervia Cinser OS
  * Arquivo: vga.h
- * Descrição: Núcleo do sistema operacional / Gerenciamento de processos.
+ * Descrição: Console em modo texto VGA (0xB8000) com scroll por hardware.
  * * Copyright (C) 2026 Tervia Corporation.
  *
  * Este programa é um software livre: você pode redistribuí-lo e/ou 
@@ -17,28 +17,16 @@
 #pragma once
 #include <stdint.h>
 
+// Backend de texto do console (usado quando nao ha framebuffer linear).
+// Cores seguem a paleta VGA de console.h (0..15).
 
-typedef enum {
-    VGA_COLOR_BLACK = 0,
-    VGA_COLOR_BLUE = 1,
-    VGA_COLOR_GREEN = 2,
-    VGA_COLOR_CYAN = 3,
-    VGA_COLOR_RED = 4,
-    VGA_COLOR_MAGENTA = 5,
-    VGA_COLOR_BROWN = 6,
-    VGA_COLOR_LIGHT_GREY = 7,
-    VGA_COLOR_DARK_GREY = 8,
-    VGA_COLOR_LIGHT_BLUE = 9,
-    VGA_COLOR_LIGHT_GREEN = 10,
-    VGA_COLOR_LIGHT_CYAN = 11,
-    VGA_COLOR_LIGHT_RED = 12,
-    VGA_COLOR_LIGHT_MAGENTA = 13,
-    VGA_COLOR_LIGHT_BROWN = 14,
-    VGA_COLOR_WHITE = 15
-} vga_color_t;
+#define VGA_TEXT_COLS 80
+#define VGA_TEXT_ROWS 25
 
-void vga_init(void);
-void vga_set_color(vga_color_t fg, vga_color_t bg);
-void vga_clear(void);
-void vga_putc(char c);
-void vga_write(const char *s);
+void vgatext_init(void);
+void vgatext_set_color(uint8_t fg, uint8_t bg);
+void vgatext_clear(void);
+void vgatext_putc(char c);
+void vgatext_write(const char* s);
+void vgatext_set_cursor(int col, int row);
+void vgatext_get_cursor(int* col, int* row);
@@ -35,8 +35,22 @@ typedef struct {
     // (Opcional) Aceleradores: quando presentes, evitam desenhar pixel-a-pixel.
     // Drivers antigos podem deixar NULL sem quebrar nada.
     void (*fill_rect)(int x, int y, int w, int h, uint32_t color);
+    // Copia um bloco 32bpp (stride em pixels) para a tela.
+    void (*blit)(int x, int y, int w, int h, const uint32_t* src, int src_stride);
+    // Copia tela->tela (areas podem se sobrepor). Retorna 0 se nao deu
+    // (ex: sem backbuffer); quem chama entao redesenha a area.
+    int (*copy_rect)(int sx, int sy, int w, int h, int dx, int dy);
+
+    // (Opcional) Cursor em overlay: desenhado por cima da tela com save-under,
+    // sem passar pelo backbuffer. Sprite 0xAARRGGBB (alpha 0 = transparente),
+    // no maximo VIDEO_CURSOR_MAX x VIDEO_CURSOR_MAX.
+    void (*cursor_set)(const uint32_t* img, int w, int h, int hot_x, int hot_y);
+    void (*cursor_move)(int x, int y);
+    void (*cursor_show)(int visible);
 } video_driver_t;
 
+#define VIDEO_CURSOR_MAX 32
+
 // Variavel global do driver ativo
 extern video_driver_t* g_video_driver;
 
@@ -44,5 +58,13 @@ extern video_driver_t* g_video_driver;
 void video_init_system(void* multiboot_info);
 void put_pixel(int x, int y, uint32_t color);
 void draw_rect(int x, int y, int w, int h, uint32_t color);
+void draw_blit(int x, int y, int w, int h, const uint32_t* src, int src_stride);
+int  video_copy_rect(int sx, int sy, int w, int h, int dx, int dy);
+
+// Cursor do mouse (no-op se o driver nao tiver overlay)
+void video_cursor_set(const uint32_t* img, int w, int h, int hot_x, int hot_y);
+void video_cursor_default(void);   // seta padrao 12x19
+void video_cursor_move(int x, int y);
+void video_cursor_show(int visible);
 
 #endif
\ No newline at end of file
@@ -26,4 +26,7 @@ volatile uint32_t* vesa_framebuffer_ptr(void);
 uint32_t vesa_pitch_pixels(void);
 void vesa_fill_rect_fast(int x, int y, int w, int h, uint32_t color);
 
+// Nome do kernel de present escolhido no init ("xrgb8888", "rgb565", ...).
+const char* vesa_present_kernel_name(void);
+
 #endif
@@ -24,12 +24,25 @@ extern "C" {
 
 typedef struct Window Window;
 
+// Resultado de window_hit()
+#define WINDOW_HIT_NONE    0
+#define WINDOW_HIT_CLIENT  1
+#define WINDOW_HIT_TITLE   2
+#define WINDOW_HIT_CLOSE   3
+
 Window* window_make(const char* title, int x, int y, int w, int h);
 void    window_close(Window* win);
 void    window_focus(Window* win);          // NULL => cycle focus
 void    window_draw_all(void);              // draw all in z-order
 void    window_key(Window* win, char c);    // sends to window (focused by desktop)
 void    window_write(Window* win, const char* text);
+void    window_write_n(Window* win, const char* buf, size_t len);
+void    window_set_cursor(Window* win, int visible); // cursor no fim do texto
+
+Window* window_at(int x, int y);                     // janela do topo sob o ponto
+int     window_hit(Window* win, int x, int y);       // WINDOW_HIT_*
+void    window_get_pos(Window* win, int* x, int* y);
+void    window_move(Window* win, int x, int y);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: acpi.c
+ * Descricao: Tabelas ACPI (RSDP/RSDT/XSDT)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "acpi.h"
+
+typedef struct {
+    char     sig[8];            // "RSD PTR "
+    uint8_t  checksum;          // soma dos 20 primeiros bytes
+    char     oem_id[6];
+    uint8_t  revision;          // 0 = ACPI 1.0, 2 = ACPI 2.0+
+    uint32_t rsdt_addr;
+    // ACPI 2.0+
+    uint32_t length;
+    uint32_t xsdt_addr_lo;
+    uint32_t xsdt_addr_hi;
+    uint8_t  ext_checksum;
+    uint8_t  reserved[3];
+} __attribute__((packed)) acpi_rsdp_t;
+
+static const acpi_sdt_t* g_root = 0;   // RSDT ou XSDT
+static int g_xsdt = 0;
+static uint8_t g_rev = 0;
+static int g_done = 0;
+
+static uint8_t sum8(const void* p, uint32_t len) {
+    const uint8_t* b = (const uint8_t*)p;
+    uint8_t s = 0;
+    for (uint32_t i = 0; i < len; i++) s = (uint8_t)(s + b[i]);
+    return s;
+}
+
+static int sig_eq(const char* a, const char* b, int n) {
+    for (int i = 0; i < n; i++) if (a[i] != b[i]) return 0;
+    return 1;
+}
+
+// Endereco fixo da BDA: o asm vazio esconde a constante do -Warray-bounds
+static uint16_t bda_read16(uintptr_t addr) {
+    __asm__("" : "+r"(addr));
+    return *(volatile uint16_t*)addr;
+}
+
+static const acpi_rsdp_t* rsdp_scan(uint32_t start, uint32_t len) {
+    // O RSDP fica sempre alinhado em 16 bytes
+    for (uint32_t p = start; p + 20 <= start + len; p += 16) {
+        const acpi_rsdp_t* r = (const acpi_rsdp_t*)(uintptr_t)p;
+        if (!sig_eq(r->sig, "RSD PTR ", 8)) continue;
+        if (sum8(r, 20) != 0) continue;
+        return r;
+    }
+    return 0;
+}
+
+static int sdt_valid(const acpi_sdt_t* t) {
+    if (!t || t->length < sizeof(acpi_sdt_t)) return 0;
+    return sum8(t, t->length) == 0;
+}
+
+int acpi_init(void) {
+    if (g_done) return g_root != 0;
+    g_done = 1;
+
+    // Primeiro KB da EBDA (segmento em 0x40E), depois a area da BIOS
+    const acpi_rsdp_t* r = 0;
+    uint32_t ebda = (uint32_t)bda_read16(0x40E) << 4;
+    if (ebda >= 0x80000 && ebda < 0xA0000) r = rsdp_scan(ebda, 1024);
+    if (!r) r = rsdp_scan(0xE0000, 0x20000);
+    if (!r) return 0;
+
+    g_rev = r->revision;
+
+    // XSDT so se couber em 32 bits (nao ha paginacao/PAE)
+    if (r->revision >= 2 && r->length >= sizeof(acpi_rsdp_t) &&
+        r->xsdt_addr_hi == 0 && r->xsdt_addr_lo &&
+        sum8(r, r->length) == 0) {
+        const acpi_sdt_t* x = (const acpi_sdt_t*)(uintptr_t)r->xsdt_addr_lo;
+        if (sdt_valid(x) && sig_eq(x->sig, "XSDT", 4)) {
+            g_root = x;
+            g_xsdt = 1;
+            return 1;
+        }
+    }
+
+    const acpi_sdt_t* t = (const acpi_sdt_t*)(uintptr_t)r->rsdt_addr;
+    if (sdt_valid(t) && sig_eq(t->sig, "RSDT", 4)) {
+        g_root = t;
+        g_xsdt = 0;
+    }
+    return g_root != 0;
+}
+
+int acpi_present(void) {
+    return g_root != 0;
+}
+
+uint8_t acpi_revision(void) {
+    return g_rev;
+}
+
+const acpi_sdt_t* acpi_find_table(const char* sig) {
+    if (!g_root || !sig) return 0;
+
+    const uint8_t* ents = (const uint8_t*)g_root + sizeof(acpi_sdt_t);
+    uint32_t esz = g_xsdt ? 8u : 4u;
+    uint32_t n = (g_root->length - sizeof(acpi_sdt_t)) / esz;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t* e = (const uint32_t*)(ents + i * esz);
+        if (g_xsdt && e[1] != 0) continue;          // acima de 4GB
+        const acpi_sdt_t* t = (const acpi_sdt_t*)(uintptr_t)e[0];
+        if (!t || !sig_eq(t->sig, sig, 4)) continue;
+        if (sdt_valid(t)) return t;
+    }
+    return 0;
+}
@@ -0,0 +1,422 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: apic.c
+ * Descricao: Local APIC e I/O APIC (MADT, EOI, timer do LAPIC)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "apic.h"
+#include "irqflags.h"
+#include "acpi.h"
+#include "cpu.h"
+#include "pit.h"
+#include "tick.h"
+#include "math.h"
+
+// Registradores do LAPIC (offset do MMIO)
+#define LAPIC_ID        0x020
+#define LAPIC_VER       0x030
+#define LAPIC_TPR       0x080
+#define LAPIC_EOI       0x0B0
+#define LAPIC_SVR       0x0F0
+#define LAPIC_ESR       0x280
+#define LAPIC_ICR_LOW   0x300
+#define LAPIC_ICR_HIGH  0x310
+#define LAPIC_LVT_TIMER 0x320
+#define LAPIC_LVT_LINT0 0x350
+#define LAPIC_LVT_LINT1 0x360
+#define LAPIC_LVT_ERROR 0x370
+#define LAPIC_TIMER_ICR 0x380
+#define LAPIC_TIMER_CCR 0x390
+#define LAPIC_TIMER_DCR 0x3E0
+
+#define LVT_MASKED      0x00010000u
+#define LVT_PERIODIC    0x00020000u
+#define LVT_NMI         0x00000400u
+#define SVR_ENABLE      0x00000100u
+#define ICR_PENDING     0x00001000u         // delivery status
+
+#define MSR_APIC_BASE   0x1B
+#define APIC_BASE_EN    0x800u
+
+// I/O APIC: seletor + janela
+#define IOAPIC_REGSEL   0x00
+#define IOAPIC_WIN      0x10
+#define IOAPIC_REG_VER  0x01
+#define IOAPIC_REDTBL   0x10
+
+#define RED_LOW_ACTIVE  0x00002000u
+#define RED_LEVEL       0x00008000u
+#define RED_MASKED      0x00010000u
+
+#define IRQ_VECTOR_BASE 0x20
+#define ISA_IRQS        16
+#define NO_GSI          0xFFFFFFFFu
+#define MAX_IOAPICS     4
+
+// Timer do LAPIC: vetor do IRQ0 (o mesmo timer_irq), divisor 16
+#define TIMER_VECTOR    IRQ_VECTOR_BASE
+#define TIMER_DIV_16    0x3
+#define CAL_LATCH       (PIT_HZ / 100u)     // 10ms
+#define CAL_ROUNDS      3
+#define CAL_SPIN_MAX    50000000u
+
+typedef struct {
+    uint8_t type;
+    uint8_t length;
+} __attribute__((packed)) madt_entry_t;
+
+typedef struct {
+    acpi_sdt_t h;
+    uint32_t lapic_addr;
+    uint32_t flags;
+} __attribute__((packed)) madt_t;
+
+typedef struct {
+    volatile uint32_t* base;
+    uint32_t gsi_base;
+    uint32_t count;
+} ioapic_t;
+
+static volatile uint32_t* g_lapic = 0;
+static ioapic_t g_ioapics[MAX_IOAPICS];
+static int g_ioapic_count = 0;
+static int g_active = 0;
+
+static uint32_t g_isa_gsi[ISA_IRQS];
+static uint32_t g_isa_flags[ISA_IRQS];     // bits de polaridade/gatilho
+
+static uint8_t g_cpus[APIC_MAX_CPUS];
+static int g_cpu_count = 0;
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return g_lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t v) {
+    g_lapic[reg / 4] = v;
+}
+
+static uint32_t ioapic_read(ioapic_t* io, uint32_t reg) {
+    io->base[IOAPIC_REGSEL / 4] = reg;
+    return io->base[IOAPIC_WIN / 4];
+}
+
+static void ioapic_write(ioapic_t* io, uint32_t reg, uint32_t v) {
+    io->base[IOAPIC_REGSEL / 4] = reg;
+    io->base[IOAPIC_WIN / 4] = v;
+}
+
+static inline uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t v) {
+    __asm__ volatile("wrmsr" :: "c"(msr), "a"((uint32_t)v), "d"((uint32_t)(v >> 32)));
+}
+
+static ioapic_t* ioapic_for(uint32_t gsi, uint32_t* pin) {
+    for (int i = 0; i < g_ioapic_count; i++) {
+        ioapic_t* io = &g_ioapics[i];
+        if (gsi >= io->gsi_base && gsi < io->gsi_base + io->count) {
+            *pin = gsi - io->gsi_base;
+            return io;
+        }
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// MADT
+// ---------------------------------------------------------------------------
+
+static int madt_parse(void) {
+    const madt_t* m = (const madt_t*)acpi_find_table("APIC");
+    if (!m) return 0;
+
+    uint32_t lapic = m->lapic_addr;
+    uint8_t ovr[ISA_IRQS];
+    for (int i = 0; i < ISA_IRQS; i++) {
+        g_isa_gsi[i] = (uint32_t)i;            // ISA: identidade por padrao
+        g_isa_flags[i] = 0;
+        ovr[i] = 0;
+    }
+
+    const uint8_t* p = (const uint8_t*)m + sizeof(madt_t);
+    const uint8_t* end = (const uint8_t*)m + m->h.length;
+
+    while (p + sizeof(madt_entry_t) <= end) {
+        const madt_entry_t* e = (const madt_entry_t*)p;
+        if (e->length < 2 || p + e->length > end) break;
+
+        switch (e->type) {
+        case 0:     // LAPIC: acpi_id, apic_id, flags (bit0 = habilitado)
+            if ((p[4] & 1u) && g_cpu_count < APIC_MAX_CPUS) g_cpus[g_cpu_count++] = p[3];
+            break;
+        case 1:     // I/O APIC: id, -, addr, gsi_base
+            if (g_ioapic_count < MAX_IOAPICS) {
+                ioapic_t* io = &g_ioapics[g_ioapic_count++];
+                io->base = (volatile uint32_t*)(uintptr_t)*(const uint32_t*)(p + 4);
+                io->gsi_base = *(const uint32_t*)(p + 8);
+            }
+            break;
+        case 2: {   // Override ISA: bus, irq, gsi, flags
+            uint8_t irq = p[3];
+            if (irq < ISA_IRQS) {
+                g_isa_gsi[irq] = *(const uint32_t*)(p + 4);
+                g_isa_flags[irq] = *(const uint16_t*)(p + 8);
+                ovr[irq] = 1;
+            }
+            break;
+        }
+        case 5:     // Endereco de 64 bits do LAPIC
+            if (*(const uint32_t*)(p + 8) == 0) lapic = *(const uint32_t*)(p + 4);
+            break;
+        }
+        p += e->length;
+    }
+
+    // Uma IRQ ISA sem override cujo GSI foi tomado por outra (IRQ2 quando
+    // IRQ0 -> GSI2) nao existe no modo APIC.
+    for (int i = 0; i < ISA_IRQS; i++) {
+        if (ovr[i]) continue;
+        for (int j = 0; j < ISA_IRQS; j++) {
+            if (ovr[j] && j != i && g_isa_gsi[j] == (uint32_t)i) g_isa_gsi[i] = NO_GSI;
+        }
+    }
+
+    g_lapic = (volatile uint32_t*)(uintptr_t)lapic;
+    return lapic != 0 && g_ioapic_count > 0;
+}
+
+// ---------------------------------------------------------------------------
+// I/O APIC
+// ---------------------------------------------------------------------------
+
+static void ioapic_setup(void) {
+    uint32_t dest = (uint32_t)apic_id() << 24;
+
+    for (int i = 0; i < g_ioapic_count; i++) {
+        ioapic_t* io = &g_ioapics[i];
+        io->count = ((ioapic_read(io, IOAPIC_REG_VER) >> 16) & 0xFFu) + 1u;
+        for (uint32_t pin = 0; pin < io->count; pin++) {
+            ioapic_write(io, IOAPIC_REDTBL + pin * 2, RED_MASKED);
+            ioapic_write(io, IOAPIC_REDTBL + pin * 2 + 1, 0);
+        }
+    }
+
+    for (int irq = 0; irq < ISA_IRQS; irq++) {
+        uint32_t pin;
+        ioapic_t* io = (g_isa_gsi[irq] == NO_GSI) ? 0 : ioapic_for(g_isa_gsi[irq], &pin);
+        if (!io) { g_isa_gsi[irq] = NO_GSI; continue; }
+
+        // Padrao ISA: borda, ativo alto. Flags da MADT: bits 0-1 polaridade
+        // (3 = baixo), bits 2-3 gatilho (3 = nivel).
+        uint32_t lo = RED_MASKED | (uint32_t)(IRQ_VECTOR_BASE + irq);
+        if ((g_isa_flags[irq] & 0x3u) == 0x3u) lo |= RED_LOW_ACTIVE;
+        if (((g_isa_flags[irq] >> 2) & 0x3u) == 0x3u) lo |= RED_LEVEL;
+
+        ioapic_write(io, IOAPIC_REDTBL + pin * 2 + 1, dest);
+        ioapic_write(io, IOAPIC_REDTBL + pin * 2, lo);
+    }
+}
+
+static void ioapic_set_masked(uint8_t irq, int masked) {
+    if (!g_active || irq >= ISA_IRQS || g_isa_gsi[irq] == NO_GSI) return;
+    uint32_t pin;
+    ioapic_t* io = ioapic_for(g_isa_gsi[irq], &pin);
+    if (!io) return;
+
+    uint32_t lo = ioapic_read(io, IOAPIC_REDTBL + pin * 2);
+    lo = masked ? (lo | RED_MASKED) : (lo & ~RED_MASKED);
+    ioapic_write(io, IOAPIC_REDTBL + pin * 2, lo);
+}
+
+void apic_irq_mask(uint8_t irq) {
+    ioapic_set_masked(irq, 1);
+}
+
+void apic_irq_unmask(uint8_t irq) {
+    ioapic_set_masked(irq, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Timer do LAPIC (clockevent)
+// ---------------------------------------------------------------------------
+
+static uint32_t g_timer_hz = 0;
+static uint32_t g_timer_mult = 0;      // pulsos = (ns * mult) >> shift
+static uint32_t g_timer_shift = 0;
+static uint32_t g_timer_lvt = LVT_MASKED;
+
+static void timer_lvt(uint32_t v) {
+    // A LVT so muda na troca de modo; no one-shot e uma escrita por IRQ
+    if (v == g_timer_lvt) return;
+    g_timer_lvt = v;
+    lapic_write(LAPIC_LVT_TIMER, v);
+}
+
+static void lapic_timer_periodic(uint32_t hz) {
+    uint32_t count = g_timer_hz / (hz ? hz : 1000u);
+    timer_lvt(TIMER_VECTOR | LVT_PERIODIC);
+    lapic_write(LAPIC_TIMER_ICR, count ? count : 1u);
+}
+
+static void lapic_timer_oneshot(uint32_t delta_ns) {
+    uint32_t count = (uint32_t)mul_u64_u32_shr(delta_ns, g_timer_mult, g_timer_shift);
+    timer_lvt(TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_ICR, count ? count : 1u);   // escrever arma
+}
+
+static void lapic_timer_shutdown(void) {
+    timer_lvt(LVT_MASKED | TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_ICR, 0);
+}
+
+static clockevent_t g_lapic_ce = {
+    .name = "lapic",
+    .rating = CLOCKEVENT_RATING_LAPIC,
+    .min_delta_ns = 2000u,
+    .set_periodic = lapic_timer_periodic,
+    .set_oneshot = lapic_timer_oneshot,
+    .shutdown = lapic_timer_shutdown,
+};
+
+static uint32_t lapic_timer_calibrate(void) {
+    uint32_t best = 0xFFFFFFFFu;
+
+    lapic_write(LAPIC_TIMER_DCR, TIMER_DIV_16);
+    for (int i = 0; i < CAL_ROUNDS; i++) {
+        lapic_write(LAPIC_LVT_TIMER, LVT_MASKED | TIMER_VECTOR);
+        pit_ch2_start((uint16_t)CAL_LATCH);
+        lapic_write(LAPIC_TIMER_ICR, 0xFFFFFFFFu);
+        uint32_t spins = 0;
+        while (!pit_ch2_expired()) {
+            if (++spins > CAL_SPIN_MAX) { lapic_write(LAPIC_TIMER_ICR, 0); return 0; }
+        }
+        uint32_t dt = 0xFFFFFFFFu - lapic_read(LAPIC_TIMER_CCR);
+        if (dt < best) best = dt;
+    }
+    lapic_write(LAPIC_TIMER_ICR, 0);
+    g_timer_lvt = LVT_MASKED | TIMER_VECTOR;
+
+    // hz = pulsos / (CAL_LATCH / PIT_HZ)
+    return (uint32_t)udiv64((uint64_t)best * PIT_HZ, CAL_LATCH, 0);
+}
+
+static void lapic_timer_init(void) {
+    uint32_t hz = lapic_timer_calibrate();
+    if (hz == 0) return;
+    g_timer_hz = hz;
+
+    // Maior shift em que mult = hz * 2^shift / 1e9 cabe em 32 bits
+    uint32_t shift = 32;
+    uint64_t m = 0;
+    for (; shift > 0; shift--) {
+        m = udiv64((uint64_t)hz << shift, 1000000000ull, 0);
+        if (m <= 0xFFFFFFFFull) break;
+    }
+    g_timer_mult = (uint32_t)m;
+    g_timer_shift = shift;
+
+    // 2^32-1 pulsos, limitado a 1s (o IRQ "de seguranca" do tickless)
+    uint64_t max_ns = udiv64(0xFFFFFFFFull * 1000000000ull, hz, 0);
+    g_lapic_ce.max_delta_ns = (max_ns > 1000000000ull) ? 1000000000u : (uint32_t)max_ns;
+
+    tick_register(&g_lapic_ce);
+}
+
+// ---------------------------------------------------------------------------
+// Init
+// ---------------------------------------------------------------------------
+
+int apic_init(void) {
+    if (g_active) return 1;
+
+    if (!cpu_has(CPU_APIC) || !cpu_has(CPU_MSR)) return 0;
+
+    if (!acpi_init() || !madt_parse()) return 0;
+
+    // Liga o LAPIC (global pelo MSR, local pelo SVR)
+    uint64_t base = rdmsr(MSR_APIC_BASE);
+    if (!(base & APIC_BASE_EN)) wrmsr(MSR_APIC_BASE, base | APIC_BASE_EN);
+
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_LVT_TIMER, LVT_MASKED | TIMER_VECTOR);
+    lapic_write(LAPIC_LVT_LINT0, LVT_MASKED);              // 8259 nao entrega mais
+    lapic_write(LAPIC_LVT_LINT1, LVT_NMI);
+    lapic_write(LAPIC_LVT_ERROR, LVT_MASKED | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_SVR, SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_EOI, 0);
+
+    // O 8259 ja esta todo mascarado (pic_init) e assim fica
+    ioapic_setup();
+    g_active = 1;
+
+    lapic_timer_init();
+    return 1;
+}
+
+// AP (smp.c): so o LAPIC local; I/O APIC e timer ficam com o BSP
+void apic_ap_init(void) {
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_LVT_TIMER, LVT_MASKED | TIMER_VECTOR);
+    lapic_write(LAPIC_LVT_LINT0, LVT_MASKED);
+    lapic_write(LAPIC_LVT_LINT1, LVT_NMI);
+    lapic_write(LAPIC_LVT_ERROR, LVT_MASKED | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_SVR, SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_EOI, 0);
+}
+
+int apic_send_ipi(uint8_t dest, uint32_t icr) {
+    if (!g_active) return 0;
+    uint32_t flags = irq_save();
+    lapic_write(LAPIC_ICR_HIGH, (uint32_t)dest << 24);
+    lapic_write(LAPIC_ICR_LOW, icr);
+    uint32_t spin = 0;
+    while ((lapic_read(LAPIC_ICR_LOW) & ICR_PENDING) && ++spin < CAL_SPIN_MAX)
+        __asm__ volatile("pause");
+    irq_restore(flags);
+    return spin < CAL_SPIN_MAX;
+}
+
+int apic_active(void) {
+    return g_active;
+}
+
+void apic_eoi(void) {
+    lapic_write(LAPIC_EOI, 0);
+}
+
+uint8_t apic_id(void) {
+    return g_lapic ? (uint8_t)(lapic_read(LAPIC_ID) >> 24) : 0;
+}
+
+int apic_cpu_count(void) {
+    return g_cpu_count ? g_cpu_count : 1;
+}
+
+uint8_t apic_cpu_apic_id(int i) {
+    if (i < 0 || i >= g_cpu_count) return apic_id();
+    return g_cpus[i];
+}
+
+uint32_t apic_timer_hz(void) {
+    return g_timer_hz;
+}
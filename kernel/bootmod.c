@@ -0,0 +1,110 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: bootmod.c
+ * Descricao: Modulos multiboot carregados pelo GRUB (lista e busca por nome).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include "bootmod.h"
+#include "multiboot.h"
+
+#define MULTIBOOT_MAGIC 0x2BADB002u
+
+static bootmod_t g_mods[BOOTMOD_MAX];
+static uint32_t g_mod_count = 0;
+
+void bootmod_init(uint32_t multiboot_magic, uint32_t mb_info_ptr) {
+    g_mod_count = 0;
+    if (multiboot_magic != MULTIBOOT_MAGIC || !mb_info_ptr) return;
+
+    const multiboot_info_t* mbi = (const multiboot_info_t*)(uintptr_t)mb_info_ptr;
+    if ((mbi->flags & (1u << 3)) == 0u) return;
+
+    const multiboot_mod_list_t* list = (const multiboot_mod_list_t*)(uintptr_t)mbi->mods_addr;
+    for (uint32_t i = 0; i < mbi->mods_count && g_mod_count < BOOTMOD_MAX; i++) {
+        if (list[i].mod_end <= list[i].mod_start) continue;
+
+        bootmod_t* m = &g_mods[g_mod_count++];
+        m->data = (const uint8_t*)(uintptr_t)list[i].mod_start;
+        m->size = list[i].mod_end - list[i].mod_start;
+
+        uint32_t n = 0;
+        const char* cmd = (const char*)(uintptr_t)list[i].cmdline;
+        if (cmd) {
+            while (cmd[n] && n < BOOTMOD_CMDLINE - 1) { m->cmdline[n] = cmd[n]; n++; }
+        }
+        m->cmdline[n] = 0;
+    }
+}
+
+uint32_t bootmod_count(void) {
+    return g_mod_count;
+}
+
+const bootmod_t* bootmod_get(uint32_t i) {
+    return (i < g_mod_count) ? &g_mods[i] : 0;
+}
+
+// Compara a palavra [s, s+n) com `name`.
+static int word_eq(const char* s, uint32_t n, const char* name) {
+    uint32_t i = 0;
+    for (; i < n; i++) {
+        if (name[i] != s[i]) return 0;
+    }
+    return name[i] == 0;
+}
+
+// Procura `name` em cada palavra; para caminhos de arquivo,
+// testa tambem o nome sem caminho e sem extensao.
+static int cmdline_has(const char* cmd, const char* name) {
+    const char* p = cmd;
+    while (*p) {
+        while (*p == ' ') p++;
+        if (!*p) break;
+        const char* w = p;
+        while (*p && *p != ' ') p++;
+        uint32_t n = (uint32_t)(p - w);
+
+        if (word_eq(w, n, name)) return 1;
+
+        const char* base = w;
+        for (const char* q = w; q < p; q++) if (*q == '/') base = q + 1;
+        const char* dot = p;
+        for (const char* q = base; q < p; q++) if (*q == '.') dot = q;
+        if (base != w || dot != p) {
+            if (word_eq(base, (uint32_t)(dot - base), name)) return 1;
+        }
+    }
+    return 0;
+}
+
+const bootmod_t* bootmod_find(const char* name) {
+    if (!name || !*name) return 0;
+    for (uint32_t i = 0; i < g_mod_count; i++) {
+        if (cmdline_has(g_mods[i].cmdline, name)) return &g_mods[i];
+    }
+    return 0;
+}
+
+int bootmod_has_arg(const bootmod_t* m, const char* arg) {
+    if (!m || !arg || !*arg) return 0;
+    const char* p = m->cmdline;
+    while (*p) {
+        while (*p == ' ') p++;
+        const char* w = p;
+        while (*p && *p != ' ') p++;
+        if (p > w && word_eq(w, (uint32_t)(p - w), arg)) return 1;
+    }
+    return 0;
+}
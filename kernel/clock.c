@@ -0,0 +1,198 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: clock.c
+ * Descricao: Clocksources (TSC calibrado, ticks do PIT) e relogio monotonico.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "clock.h"
+#include "irqflags.h"
+#include "cpu.h"
+#include "pit.h"
+#include "math.h"
+#include "sysconfig.h"
+
+// Calibracao: 3 janelas de 10ms no canal 2 do PIT, fica a menor (a que
+// sofreu menos interferencia de SMI/VM exit).
+#define CAL_MS      10u
+#define CAL_LATCH   (PIT_HZ / (1000u / CAL_MS))
+#define CAL_ROUNDS  3
+#define CAL_SPIN_MAX 50000000u
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// ---------------------------------------------------------------------------
+// Fonte 1: ticks do timer periodico (sempre existe, resolucao de 1 tick)
+// ---------------------------------------------------------------------------
+
+static volatile uint64_t g_jiffies = 0;
+
+void clock_tick(void) {
+    g_jiffies++;
+}
+
+uint64_t clock_jiffies(void) {
+    uint32_t flags = irq_save();
+    uint64_t j = g_jiffies;
+    irq_restore(flags);
+    return j;
+}
+
+static clocksource_t g_jiffies_cs = {
+    .name = "jiffies",
+    .read = clock_jiffies,
+    .rating = CLOCK_RATING_JIFFIES,
+};
+
+// ---------------------------------------------------------------------------
+// Fonte 2: TSC
+// ---------------------------------------------------------------------------
+
+static uint64_t tsc_read(void) {
+    return rdtsc();
+}
+
+static clocksource_t g_tsc_cs = {
+    .name = "tsc",
+    .read = tsc_read,
+};
+
+static int g_has_tsc = 0;
+
+static uint64_t tsc_calibrate(void) {
+    uint64_t best = ~0ull;
+    uint32_t flags = irq_save();
+
+    for (int i = 0; i < CAL_ROUNDS; i++) {
+        pit_ch2_start((uint16_t)CAL_LATCH);
+        uint64_t t0 = rdtsc();
+        uint32_t spins = 0;
+        while (!pit_ch2_expired()) {
+            if (++spins > CAL_SPIN_MAX) { irq_restore(flags); return 0; }
+        }
+        uint64_t dt = rdtsc() - t0;
+        if (dt < best) best = dt;
+    }
+
+    irq_restore(flags);
+    // hz = ciclos / (CAL_LATCH / PIT_HZ)
+    return udiv64(best * PIT_HZ, CAL_LATCH, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Registro / selecao
+// ---------------------------------------------------------------------------
+
+static clocksource_t* g_sources = 0;
+static clocksource_t* g_cs = &g_jiffies_cs;
+static uint64_t g_base_ns = 0;      // clock_ns() no momento da troca de fonte
+static uint64_t g_base_cyc = 0;     // leitura da fonte nesse momento
+
+// Maior shift (<= 32) em que mult ainda cabe em 32 bits: maximo de precisao.
+static void calc_mult_shift(clocksource_t* cs) {
+    uint32_t shift = 32;
+    uint64_t m = 0;
+    for (; shift > 0; shift--) {
+        m = udiv64(1000000000ull << shift, cs->freq_hz, 0);
+        if (m <= 0xFFFFFFFFull) break;
+    }
+    cs->mult = (uint32_t)m;
+    cs->shift = shift;
+}
+
+void clock_register(clocksource_t* cs) {
+    if (!cs || !cs->read || cs->freq_hz == 0) return;
+    calc_mult_shift(cs);
+    cs->next = g_sources;
+    g_sources = cs;
+
+    if (cs == g_cs || cs->rating <= g_cs->rating) return;
+
+    uint32_t flags = irq_save();
+    uint64_t now = clock_ns();
+    g_base_cyc = cs->read();
+    g_base_ns = now;
+    g_cs = cs;
+    irq_restore(flags);
+}
+
+const char* clock_source_name(void) {
+    return g_cs->name;
+}
+
+int clock_is_continuous(void) {
+    return g_cs != &g_jiffies_cs;
+}
+
+void clock_init(uint32_t tick_hz) {
+    if (tick_hz == 0) tick_hz = 1000;
+    g_jiffies_cs.freq_hz = tick_hz;
+    clock_register(&g_jiffies_cs);
+
+    g_has_tsc = cpu_has(CPU_TSC);
+    if (!g_has_tsc) return;
+
+    uint64_t hz = tsc_calibrate();
+    if (hz == 0) {
+        // Canal 2 nao respondeu (alguns emuladores): usa o CPUID 0x16
+        hz = (uint64_t)sysconfig_cpu_base_mhz() * 1000000ull;
+    }
+    if (hz == 0) { g_has_tsc = 0; return; }
+
+    int inv = cpu_has(CPU_INVTSC);
+
+    g_tsc_cs.freq_hz = hz;
+    g_tsc_cs.rating = inv ? CLOCK_RATING_TSC_INV : CLOCK_RATING_TSC;
+    clock_register(&g_tsc_cs);
+}
+
+// ---------------------------------------------------------------------------
+// Leitura
+// ---------------------------------------------------------------------------
+
+uint64_t clock_ns(void) {
+    clocksource_t* cs = g_cs;
+    if (!cs->mult) return 0;        // antes do clock_init()
+    return g_base_ns + mul_u64_u32_shr(cs->read() - g_base_cyc, cs->mult, cs->shift);
+}
+
+// ns/1000 e ns/1e6 por multiplicacao (2^41/1e3 e 2^50/1e6, arredondados pra cima)
+uint64_t clock_us(void) {
+    return mul_u64_u32_shr(clock_ns(), 2199023256u, 41);
+}
+
+uint32_t clock_ms(void) {
+    return (uint32_t)mul_u64_u32_shr(clock_ns(), 1125899907u, 50);
+}
+
+uint64_t clock_cycles(void) {
+    return g_has_tsc ? rdtsc() : clock_ns();
+}
+
+uint64_t clock_cycles_to_ns(uint64_t cycles) {
+    if (!g_has_tsc) return cycles;
+    return mul_u64_u32_shr(cycles, g_tsc_cs.mult, g_tsc_cs.shift);
+}
+
+uint64_t clock_tsc_hz(void) {
+    return g_has_tsc ? g_tsc_cs.freq_hz : 0;
+}
+
+uint32_t clock_cpu_mhz(void) {
+    if (!g_has_tsc) return 0;
+    return (uint32_t)udiv64(g_tsc_cs.freq_hz + 500000ull, 1000000ull, 0);
+}
@@ -16,15 +16,27 @@
 
 #include <stdint.h>
 #include "io.h"
+#include "irqflags.h"
 #include "cmos.h"
 
 #define CMOS_ADDR 0x70
 #define CMOS_DATA 0x71
 
-static inline uint8_t cmos_read(uint8_t reg) {
+// index + data with IRQs off: the IRQ8 handler also uses port 0x70
+static uint8_t cmos_read(uint8_t reg) {
     // keep NMI enabled (bit7=0). If you want to disable NMI: reg | 0x80
+    uint32_t flags = irq_save();
     outb(CMOS_ADDR, reg);
-    return inb(CMOS_DATA);
+    uint8_t v = inb(CMOS_DATA);
+    irq_restore(flags);
+    return v;
+}
+
+static void cmos_write(uint8_t reg, uint8_t v) {
+    uint32_t flags = irq_save();
+    outb(CMOS_ADDR, reg);
+    outb(CMOS_DATA, v);
+    irq_restore(flags);
 }
 
 static inline int cmos_uip(void) {
@@ -35,10 +47,8 @@ static inline uint8_t bcd_to_bin(uint8_t bcd) {
     return (uint8_t)((bcd & 0x0F) + ((bcd >> 4) * 10));
 }
 
-void cmos_read_rtc(rtc_time_t *out) {
-    // wait update cycle end
-    while (cmos_uip()) { }
-
+// read + decode; the caller makes sure no update is in progress
+static void rtc_decode(rtc_time_t *out) {
     uint8_t sec  = cmos_read(0x00);
     uint8_t min  = cmos_read(0x02);
     uint8_t hour = cmos_read(0x04);
@@ -84,3 +94,26 @@ void cmos_read_rtc(rtc_time_t *out) {
     out->mon = mon;
     out->year = (uint16_t)(2000 + year);
 }
+
+void cmos_read_rtc(rtc_time_t *out) {
+    // wait update cycle end (boot only; afterwards IRQ8 says when to read)
+    while (cmos_uip()) { }
+    rtc_decode(out);
+}
+
+int cmos_read_rtc_now(rtc_time_t *out) {
+    if (cmos_uip()) return 0;
+    rtc_decode(out);
+    return 1;
+}
+
+void cmos_rtc_irq_enable(void) {
+    // register B bit 4 (UIE): IRQ8 after every update cycle (1Hz)
+    cmos_write(0x0B, (uint8_t)(cmos_read(0x0B) | 0x10));
+    (void)cmos_read(0x0C);
+}
+
+uint8_t cmos_rtc_irq_ack(void) {
+    // the RTC raises no further IRQ8 until register C is read
+    return cmos_read(0x0C);
+}
@@ -0,0 +1,262 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: compositor.c
+ * Descricao: Compositor: lista de camadas por z, damage rects e oclusao.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "compositor.h"
+#include "video.h"
+
+#define COMP_MAX_LAYERS  32
+#define COMP_MAX_DAMAGE  32
+#define COMP_WORK_MAX    128
+
+typedef struct { int x, y, w, h; } crect_t;
+
+// g_layers[0] = topo. Poucas camadas: array ordenado e suficiente.
+static comp_layer_t* g_layers[COMP_MAX_LAYERS];
+static int g_layer_count = 0;
+
+static crect_t g_damage[COMP_MAX_DAMAGE];
+static int g_damage_count = 0;
+
+static comp_background_fn g_background = NULL;
+
+static int screen_w(void) { return (g_video_driver && g_video_driver->width  > 0) ? g_video_driver->width  : 0; }
+static int screen_h(void) { return (g_video_driver && g_video_driver->height > 0) ? g_video_driver->height : 0; }
+
+static int rect_intersect(const crect_t* a, const crect_t* b, crect_t* out) {
+    int x0 = a->x > b->x ? a->x : b->x;
+    int y0 = a->y > b->y ? a->y : b->y;
+    int x1 = (a->x + a->w) < (b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int y1 = (a->y + a->h) < (b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+    if (x1 <= x0 || y1 <= y0) return 0;
+    out->x = x0; out->y = y0; out->w = x1 - x0; out->h = y1 - y0;
+    return 1;
+}
+
+static void rect_union(crect_t* a, const crect_t* b) {
+    int x0 = a->x < b->x ? a->x : b->x;
+    int y0 = a->y < b->y ? a->y : b->y;
+    int x1 = (a->x + a->w) > (b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int y1 = (a->y + a->h) > (b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+    a->x = x0; a->y = y0; a->w = x1 - x0; a->h = y1 - y0;
+}
+
+static int rect_contains(const crect_t* a, const crect_t* b) {
+    return b->x >= a->x && b->y >= a->y &&
+           b->x + b->w <= a->x + a->w && b->y + b->h <= a->y + a->h;
+}
+
+static int layer_index(const comp_layer_t* l) {
+    for (int i = 0; i < g_layer_count; i++) if (g_layers[i] == l) return i;
+    return -1;
+}
+
+void comp_set_background(comp_background_fn fn) {
+    g_background = fn;
+}
+
+void comp_damage(int x, int y, int w, int h) {
+    crect_t scr = { 0, 0, screen_w(), screen_h() };
+    crect_t r = { x, y, w, h };
+    if (!rect_intersect(&r, &scr, &r)) return;
+
+    // Descarta se ja coberto; absorve os que este cobre.
+    for (int i = 0; i < g_damage_count; i++) {
+        if (rect_contains(&g_damage[i], &r)) return;
+    }
+    int n = 0;
+    for (int i = 0; i < g_damage_count; i++) {
+        if (!rect_contains(&r, &g_damage[i])) g_damage[n++] = g_damage[i];
+    }
+    g_damage_count = n;
+
+    if (g_damage_count == COMP_MAX_DAMAGE) {
+        // Lista cheia: funde tudo num unico retangulo envolvente.
+        for (int i = 1; i < g_damage_count; i++) rect_union(&g_damage[0], &g_damage[i]);
+        g_damage_count = 1;
+        rect_union(&g_damage[0], &r);
+        return;
+    }
+    g_damage[g_damage_count++] = r;
+}
+
+void comp_damage_all(void) {
+    g_damage_count = 0;
+    comp_damage(0, 0, screen_w(), screen_h());
+}
+
+void comp_layer_damage(comp_layer_t* l, int x, int y, int w, int h) {
+    if (!l || !l->linked || !l->visible) return;
+    crect_t lr = { 0, 0, l->w, l->h };
+    crect_t r = { x, y, w, h };
+    if (!rect_intersect(&r, &lr, &r)) return;
+    comp_damage(l->x + r.x, l->y + r.y, r.w, r.h);
+}
+
+int comp_layer_add(comp_layer_t* l) {
+    if (!l) return -1;
+    if (l->linked) return 0;
+    if (g_layer_count >= COMP_MAX_LAYERS) return -1;
+    for (int i = g_layer_count; i > 0; i--) g_layers[i] = g_layers[i - 1];
+    g_layers[0] = l;
+    g_layer_count++;
+    l->linked = 1;
+    comp_layer_damage(l, 0, 0, l->w, l->h);
+    return 0;
+}
+
+void comp_layer_remove(comp_layer_t* l) {
+    int idx = layer_index(l);
+    if (idx < 0) return;
+    if (l->visible) comp_damage(l->x, l->y, l->w, l->h);
+    for (int i = idx; i < g_layer_count - 1; i++) g_layers[i] = g_layers[i + 1];
+    g_layer_count--;
+    l->linked = 0;
+}
+
+void comp_layer_raise(comp_layer_t* l) {
+    int idx = layer_index(l);
+    if (idx <= 0) return;
+    for (int i = idx; i > 0; i--) g_layers[i] = g_layers[i - 1];
+    g_layers[0] = l;
+    // So o que estava escondido por cima dela precisa ser recomposto,
+    // mas recompor o retangulo todo e barato e simples.
+    comp_layer_damage(l, 0, 0, l->w, l->h);
+}
+
+// Marca como damage a parte de `a` fora de `b` (ate 4 tiras).
+static void damage_minus(const crect_t* a, const crect_t* b) {
+    crect_t in;
+    if (!rect_intersect(a, b, &in)) { comp_damage(a->x, a->y, a->w, a->h); return; }
+    if (in.y > a->y)                 comp_damage(a->x, a->y, a->w, in.y - a->y);
+    if (in.y + in.h < a->y + a->h)   comp_damage(a->x, in.y + in.h, a->w, (a->y + a->h) - (in.y + in.h));
+    if (in.x > a->x)                 comp_damage(a->x, in.y, in.x - a->x, in.h);
+    if (in.x + in.w < a->x + a->w)   comp_damage(in.x + in.w, in.y, (a->x + a->w) - (in.x + in.w), in.h);
+}
+
+static void compose_damage(void);
+
+void comp_layer_move(comp_layer_t* l, int x, int y) {
+    if (!l || (l->x == x && l->y == y)) return;
+
+    int idx = layer_index(l);
+    if (idx < 0 || !l->visible) { l->x = x; l->y = y; return; }
+
+    crect_t old = { l->x, l->y, l->w, l->h };
+    crect_t scr = { 0, 0, screen_w(), screen_h() };
+    int dx = x - l->x;
+    int dy = y - l->y;
+
+    // Camada do topo: a tela ja mostra exatamente os pixels dela. Copia
+    // tela->tela e so re-expoe o que ficou descoberto, sem re-renderizar.
+    if (idx == 0) {
+        compose_damage();   // a tela precisa estar em dia antes da copia
+
+        crect_t src;
+        if (rect_intersect(&old, &scr, &src) &&
+            video_copy_rect(src.x, src.y, src.w, src.h, src.x + dx, src.y + dy)) {
+            l->x = x; l->y = y;
+            crect_t now = { x, y, l->w, l->h };
+            crect_t copied = { src.x + dx, src.y + dy, src.w, src.h };
+            damage_minus(&now, &copied);    // partes que estavam fora da tela
+            damage_minus(&old, &now);       // tiras expostas
+            return;
+        }
+    }
+
+    comp_damage(old.x, old.y, old.w, old.h);
+    l->x = x;
+    l->y = y;
+    comp_layer_damage(l, 0, 0, l->w, l->h);
+}
+
+static void blit_from_layer(const comp_layer_t* l, const crect_t* r) {
+    const uint32_t* src = l->pixels + (uint32_t)(r->y - l->y) * (uint32_t)l->w + (uint32_t)(r->x - l->x);
+    draw_blit(r->x, r->y, r->w, r->h, src, l->w);
+}
+
+// Pinta `r` considerando apenas camadas a partir de `first` (para baixo).
+// A parte coberta pela primeira camada que intersecta e copiada dela; o resto
+// (ate 4 tiras) volta para a pilha e continua descendo. Cada pixel danificado
+// e escrito exatamente uma vez.
+static void compose_rect(const crect_t* dmg) {
+    static crect_t work[COMP_WORK_MAX];
+    static int work_first[COMP_WORK_MAX];
+    int sp = 0;
+
+    work[sp] = *dmg; work_first[sp] = 0; sp++;
+
+    while (sp > 0) {
+        sp--;
+        crect_t r = work[sp];
+        int i = work_first[sp];
+
+        crect_t hit;
+        const comp_layer_t* l = NULL;
+        for (; i < g_layer_count; i++) {
+            l = g_layers[i];
+            if (!l->visible || !l->pixels) continue;
+            crect_t lr = { l->x, l->y, l->w, l->h };
+            if (rect_intersect(&r, &lr, &hit)) break;
+        }
+
+        if (i >= g_layer_count) {
+            if (g_background) g_background(r.x, r.y, r.w, r.h);
+            continue;
+        }
+
+        blit_from_layer(l, &hit);
+
+        crect_t piece[4];
+        int pn = 0;
+        if (hit.y > r.y)                       piece[pn++] = (crect_t){ r.x, r.y, r.w, hit.y - r.y };
+        if (hit.y + hit.h < r.y + r.h)         piece[pn++] = (crect_t){ r.x, hit.y + hit.h, r.w, (r.y + r.h) - (hit.y + hit.h) };
+        if (hit.x > r.x)                       piece[pn++] = (crect_t){ r.x, hit.y, hit.x - r.x, hit.h };
+        if (hit.x + hit.w < r.x + r.w)         piece[pn++] = (crect_t){ hit.x + hit.w, hit.y, (r.x + r.w) - (hit.x + hit.w), hit.h };
+
+        for (int p = 0; p < pn; p++) {
+            if (sp < COMP_WORK_MAX) {
+                work[sp] = piece[p]; work_first[sp] = i + 1; sp++;
+                continue;
+            }
+            // Pilha cheia (muitas camadas sobrepostas): pinta a tira de baixo
+            // para cima. Mais lento, mas correto.
+            if (g_background) g_background(piece[p].x, piece[p].y, piece[p].w, piece[p].h);
+            for (int j = g_layer_count - 1; j > i; j--) {
+                const comp_layer_t* lj = g_layers[j];
+                if (!lj->visible || !lj->pixels) continue;
+                crect_t ljr = { lj->x, lj->y, lj->w, lj->h };
+                crect_t h2;
+                if (rect_intersect(&piece[p], &ljr, &h2)) blit_from_layer(lj, &h2);
+            }
+        }
+    }
+}
+
+static void compose_damage(void) {
+    for (int d = 0; d < g_damage_count; d++) compose_rect(&g_damage[d]);
+    g_damage_count = 0;
+}
+
+void comp_compose(void) {
+    if (g_damage_count == 0) return;
+
+    compose_damage();
+
+    if (g_video_driver && g_video_driver->update) g_video_driver->update();
+}
@@ -0,0 +1,173 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: cpu.c
+ * Descricao: Registro de recursos da CPU (CPUID) e selecao de variantes
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "cpu.h"
+
+static uint64_t g_caps = 0;
+static char g_vendor[13];
+static uint32_t g_family = 0;
+static uint32_t g_model = 0;
+
+static const char* const g_names[CPU_FEATURE_COUNT] = {
+    "fpu", "vme", "pse", "tsc", "msr", "pae", "cx8", "apic",
+    "sep", "mtrr", "pge", "cmov", "pat", "clflush", "mmx",
+    "fxsr", "sse", "sse2", "htt",
+    "sse3", "pclmul", "monitor", "ssse3", "fma", "cx16",
+    "sse4.1", "sse4.2", "x2apic", "movbe", "popcnt", "tsc_deadline",
+    "aes", "xsave", "osxsave", "avx", "f16c", "rdrand",
+    "hypervisor",
+    "mwait_irq", "arat",
+    "fsgsbase", "bmi1", "avx2", "smep", "bmi2", "erms",
+    "rdseed", "adx", "smap", "clflushopt", "sha", "fsrm",
+    "syscall", "nx", "rdtscp", "lm", "lzcnt", "invtsc",
+};
+
+// Bit do registro -> recurso
+typedef struct {
+    uint8_t bit;
+    uint8_t feature;
+} cpu_bit_t;
+
+static const cpu_bit_t g_leaf1_edx[] = {
+    {0, CPU_FPU}, {1, CPU_VME}, {3, CPU_PSE}, {4, CPU_TSC}, {5, CPU_MSR},
+    {6, CPU_PAE}, {8, CPU_CX8}, {9, CPU_APIC}, {11, CPU_SEP}, {12, CPU_MTRR},
+    {13, CPU_PGE}, {15, CPU_CMOV}, {16, CPU_PAT}, {19, CPU_CLFLUSH},
+    {23, CPU_MMX}, {24, CPU_FXSR}, {25, CPU_SSE}, {26, CPU_SSE2}, {28, CPU_HTT},
+};
+
+static const cpu_bit_t g_leaf1_ecx[] = {
+    {0, CPU_SSE3}, {1, CPU_PCLMUL}, {3, CPU_MONITOR}, {9, CPU_SSSE3},
+    {12, CPU_FMA}, {13, CPU_CX16}, {19, CPU_SSE41}, {20, CPU_SSE42},
+    {21, CPU_X2APIC}, {22, CPU_MOVBE}, {23, CPU_POPCNT}, {24, CPU_TSC_DEADLINE},
+    {25, CPU_AES}, {26, CPU_XSAVE}, {27, CPU_OSXSAVE}, {28, CPU_AVX},
+    {29, CPU_F16C}, {30, CPU_RDRAND}, {31, CPU_HYPERVISOR},
+};
+
+static const cpu_bit_t g_leaf7_ebx[] = {
+    {0, CPU_FSGSBASE}, {3, CPU_BMI1}, {5, CPU_AVX2}, {7, CPU_SMEP},
+    {8, CPU_BMI2}, {9, CPU_ERMS}, {18, CPU_RDSEED}, {19, CPU_ADX},
+    {20, CPU_SMAP}, {23, CPU_CLFLUSHOPT}, {29, CPU_SHA},
+};
+
+static const cpu_bit_t g_ext1_edx[] = {
+    {11, CPU_SYSCALL}, {20, CPU_NX}, {27, CPU_RDTSCP}, {29, CPU_LM},
+};
+
+static inline void cpuid(uint32_t leaf, uint32_t sub, uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) {
+    __asm__ volatile("cpuid" : "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d) : "a"(leaf), "c"(sub));
+}
+
+static void map_bits(uint32_t reg, const cpu_bit_t* t, int n) {
+    for (int i = 0; i < n; i++) {
+        if ((reg >> t[i].bit) & 1u) g_caps |= CPU_F(t[i].feature);
+    }
+}
+
+#define MAP(reg, table) map_bits((reg), (table), (int)(sizeof(table) / sizeof((table)[0])))
+
+// CPUID existe se o bit ID (21) do EFLAGS pode ser trocado (486 antigo nao tem)
+static int cpuid_present(void) {
+    uint32_t a, b;
+    __asm__ volatile(
+        "pushfl\n\t"
+        "pushfl\n\t"
+        "popl %0\n\t"
+        "movl %0, %1\n\t"
+        "xorl $0x200000, %0\n\t"
+        "pushl %0\n\t"
+        "popfl\n\t"
+        "pushfl\n\t"
+        "popl %0\n\t"
+        "popfl"
+        : "=&r"(a), "=&r"(b) :: "cc");
+    return ((a ^ b) & 0x200000u) != 0;
+}
+
+void cpu_init(void) {
+    g_caps = 0;
+    for (int i = 0; i < 13; i++) g_vendor[i] = 0;
+    if (!cpuid_present()) return;
+
+    uint32_t a, b, c, d;
+    cpuid(0, 0, &a, &b, &c, &d);
+    uint32_t max_basic = a;
+    *(uint32_t*)&g_vendor[0] = b;
+    *(uint32_t*)&g_vendor[4] = d;
+    *(uint32_t*)&g_vendor[8] = c;
+
+    if (max_basic >= 1) {
+        cpuid(1, 0, &a, &b, &c, &d);
+        g_family = (a >> 8) & 0xFu;
+        g_model = (a >> 4) & 0xFu;
+        if (g_family == 0xFu) g_family += (a >> 20) & 0xFFu;
+        if (g_family == 0xFu || g_family == 6u) g_model |= ((a >> 16) & 0xFu) << 4;
+        MAP(d, g_leaf1_edx);
+        MAP(c, g_leaf1_ecx);
+    }
+    if (max_basic >= 5 && cpu_has(CPU_MONITOR)) {
+        cpuid(5, 0, &a, &b, &c, &d);
+        if ((c & 3u) == 3u) g_caps |= CPU_F(CPU_MWAIT_IRQ);     // extensoes + break com IF=0
+    }
+    if (max_basic >= 6) {
+        cpuid(6, 0, &a, &b, &c, &d);
+        if ((a >> 2) & 1u) g_caps |= CPU_F(CPU_ARAT);
+    }
+    if (max_basic >= 7) {
+        cpuid(7, 0, &a, &b, &c, &d);
+        MAP(b, g_leaf7_ebx);
+        if ((d >> 4) & 1u) g_caps |= CPU_F(CPU_FSRM);
+    }
+
+    cpuid(0x80000000u, 0, &a, &b, &c, &d);
+    uint32_t max_ext = a;
+    if (max_ext >= 0x80000001u) {
+        cpuid(0x80000001u, 0, &a, &b, &c, &d);
+        MAP(d, g_ext1_edx);
+        if ((c >> 5) & 1u) g_caps |= CPU_F(CPU_LZCNT);
+    }
+    if (max_ext >= 0x80000007u) {
+        cpuid(0x80000007u, 0, &a, &b, &c, &d);
+        if ((d >> 8) & 1u) g_caps |= CPU_F(CPU_INVTSC);
+    }
+}
+
+int cpu_has(cpu_feature_t f) {
+    return (f < CPU_FEATURE_COUNT) && ((g_caps >> f) & 1u);
+}
+
+const char* cpu_feature_name(cpu_feature_t f) {
+    return (f < CPU_FEATURE_COUNT) ? g_names[f] : "?";
+}
+
+const char* cpu_vendor(void) {
+    return g_vendor;
+}
+
+uint32_t cpu_family(void) {
+    return g_family;
+}
+
+uint32_t cpu_model(void) {
+    return g_model;
+}
+
+const cpu_variant_t* cpu_select(const cpu_variant_t* list, int count) {
+    for (int i = 0; i < count; i++) {
+        if ((list[i].needs & g_caps) == list[i].needs) return &list[i];
+    }
+    return (count > 0) ? &list[count - 1] : 0;
+}
@@ -16,9 +16,9 @@
 
 #include <stdint.h>
 #include "delay.h"
-
-/* Updated on each timer IRQ */
-static volatile uint32_t g_ticks = 0;
+#include "clock.h"
+#include "tick.h"
+#include "idle.h"
 
 /* Ticks per second (same value used by time_init / PIT programming) */
 static uint32_t g_tps = 1000;
@@ -26,66 +26,50 @@ static uint32_t g_tps = 1000;
 void delay_init(uint32_t ticks_per_sec) {
     if (ticks_per_sec == 0) ticks_per_sec = 1000;
     g_tps = ticks_per_sec;
-    g_ticks = 0;
-}
-
-void delay_tick(void) {
-    g_ticks++;
 }
 
 uint32_t delay_get_ticks(void) {
-    return g_ticks;
+    /* jiffies stop advancing at 1 kHz once the tick goes one-shot */
+    return clock_ms();
 }
 
-/* Internal: CPU halt until next interrupt */
-static inline void cpu_halt(void) {
-    __asm__ __volatile__("hlt");
+/*
+  All waits are measured against clock_ns() (single source of truth, see
+  clock.h), so they are exact even when the tick rate changes. Sleeping
+  waits halt between checks; delay_us() spins and works with IRQs off.
+*/
+static void wait_ns(uint64_t ns) {
+    uint64_t deadline = clock_ns() + ns;
+    for (;;) {
+        /* cli..sti;hlt: no timer IRQ can slip in between check and halt */
+        __asm__ __volatile__("cli");
+        if (clock_ns() >= deadline) break;
+        tick_wake_at(deadline);         /* tickless: IRQ at the deadline */
+        cpu_idle();                     /* softirqs, idle work or halt; sti */
+    }
+    __asm__ __volatile__("sti");
 }
 
 void delay_ticks(uint32_t ticks) {
     if (ticks == 0) return;
-
-    uint32_t start = g_ticks;
-
-    /* Wait until (g_ticks - start) >= ticks, handles wrap-around naturally */
-    while ((uint32_t)(g_ticks - start) < ticks) {
-        cpu_halt();
-    }
+    if (g_tps == 0) g_tps = 1000;
+    wait_ns((uint64_t)ticks * (1000000000u / g_tps));
 }
 
 void delay_time(uint32_t seconds) {
     if (seconds == 0) return;
-    if (g_tps == 0) g_tps = 1000;
-
-    while (seconds--) {
-        delay_ticks(g_tps);
-    }
+    wait_ns((uint64_t)seconds * 1000000000ull);
 }
 
 void delay_ms(uint32_t ms) {
     if (ms == 0) return;
-    if (g_tps == 0) g_tps = 1000;
-
-    /*
-      Compute ticks = ceil(ms * tps / 1000) without 64-bit math:
-
-        ms = q*1000 + r
-        ms*tps/1000 = q*tps + (r*tps)/1000
-
-      We do a ceil by rounding up if there is remainder.
-    */
-    uint32_t q = ms / 1000;
-    uint32_t r = ms % 1000;
-
-    uint32_t ticks = q * g_tps;
-
-    uint32_t r_mul = r * g_tps;           /* <= 999*~1000 fits 32-bit */
-    uint32_t extra = r_mul / 1000;
-    uint32_t rem   = r_mul % 1000;
-
-    ticks += extra;
-    if (rem != 0) ticks += 1;             /* ceil */
+    wait_ns((uint64_t)ms * 1000000ull);
+}
 
-    if (ticks == 0) ticks = 1;
-    delay_ticks(ticks);
+void delay_us(uint32_t us) {
+    if (us == 0) return;
+    uint64_t deadline = clock_ns() + (uint64_t)us * 1000u;
+    while (clock_ns() < deadline) {
+        __asm__ __volatile__("pause");
+    }
 }
@@ -19,12 +19,27 @@
 
 #include "video.h"
 #include "window.h"
+#include "compositor.h"
+#include "mouse.h"
+#include "event.h"
+#include "keyboard.h"
+#include "time.h"
+#include "memory.h"
+#include "bootmod.h"
+#include "image.h"
 #include "programs/shell.h"
 
 static Window* g_focused = NULL;
 
-// Variável de controle (estática = mantém valor entre chamadas)
-static int g_bg_painted = 0;
+#define DESKTOP_BG_COLOR 0x00204A87
+#define DESKTOP_FRAME_MS 16
+
+// Arrasto de janela pela barra de título. O mouse só guarda o destino;
+// a janela anda uma vez por frame em desktop_draw (coalesce os pacotes).
+static Window* g_drag = NULL;
+static int g_drag_offx = 0, g_drag_offy = 0;
+static int g_drag_tx = 0, g_drag_ty = 0;
+static uint8_t g_prev_buttons = 0;
 
 void __desktop_set_focused(Window* w) { g_focused = w; }
 
@@ -36,29 +51,164 @@ static void fill_rect(int x, int y, int w, int h, uint32_t color) {
     }
 }
 
+// Wallpaper: módulo "wallpaper" do GRUB (QOI ou BMP), decodificado uma vez
+// já no tamanho da tela. Depois disso o fundo danificado volta por blit.
+static uint32_t* g_wallpaper = NULL;
+static int g_wallpaper_w = 0;
+static int g_wallpaper_tried = 0;
+
+static void desktop_load_wallpaper(void) {
+    if (g_wallpaper_tried) return;
+    g_wallpaper_tried = 1;
+
+    const bootmod_t* m = bootmod_find("wallpaper");
+    if (!m || !g_video_driver || g_video_driver->width <= 0 || g_video_driver->height <= 0) return;
+    if (image_probe(m->data, m->size, NULL, NULL) == IMAGE_NONE) return;
+
+    int W = g_video_driver->width;
+    int H = g_video_driver->height;
+    uint32_t* surf = (uint32_t*)kmalloc((uint32_t)W * (uint32_t)H * 4u);
+    if (!surf) return;
+
+    // "module /boot/wallpaper.qoi wallpaper nearest" troca o filtro.
+    int filter = bootmod_has_arg(m, "nearest") ? IMAGE_SCALE_NEAREST : IMAGE_SCALE_BILINEAR;
+    if (!image_decode_scaled(m->data, m->size, surf, W, H, W, filter)) {
+        kfree(surf);
+        return;
+    }
+    g_wallpaper = surf;
+    g_wallpaper_w = W;
+}
+
+// Fundo do desktop: o compositor só chama isso para áreas descobertas.
+static void desktop_paint_bg(int x, int y, int w, int h) {
+    if (g_wallpaper) {
+        draw_blit(x, y, w, h, g_wallpaper + (uint32_t)y * (uint32_t)g_wallpaper_w + (uint32_t)x, g_wallpaper_w);
+        return;
+    }
+    fill_rect(x, y, w, h, DESKTOP_BG_COLOR);
+}
+
 void desktop_init(void) {
+    desktop_load_wallpaper();
+    comp_set_background(desktop_paint_bg);
     shell_open();
-    g_bg_painted = 0; // Reseta no boot
+    comp_damage_all(); // Primeiro frame pinta a tela inteira
+
+    // Ponteiro do mouse: overlay do driver de video (nao passa pelo compositor)
+    if (g_video_driver && g_video_driver->width > 0 && g_video_driver->height > 0) {
+        mouse_set_bounds(0, 0, g_video_driver->width - 1, g_video_driver->height - 1);
+    }
+    mouse_state_t ms;
+    mouse_get_state(&ms);
+    video_cursor_default();
+    video_cursor_move(ms.x, ms.y);
+    video_cursor_show(1);
 }
 
 void desktop_draw(void) {
-    // 1. Pinta fundo AZUL (Só na primeira vez!)
-    if (!g_bg_painted) {
-        int W = 1024;
-        int H = 768;
-        if (g_video_driver && g_video_driver->width > 0)  W = g_video_driver->width;
-        if (g_video_driver && g_video_driver->height > 0) H = g_video_driver->height;
-
-        fill_rect(0, 0, W, H, 0x00204A87);
-        g_bg_painted = 1; // Trava para não pintar mais
-    }
+    if (g_drag) window_move(g_drag, g_drag_tx, g_drag_ty);
 
-    // 2. Desenha janelas (Shell)
+    // Janelas sujas são re-renderizadas e só o damage vai para a tela.
     window_draw_all();
 }
 
 void desktop_key(char c) {
     if (c == '\t') { window_focus(NULL); return; }
+    if (c == 23 && g_focused == g_drag) g_drag = NULL; // Ctrl+W fecha a janela
     if (g_focused) window_key(g_focused, c);
     else window_focus(NULL);
-}
\ No newline at end of file
+}
+
+int desktop_mouse(int x, int y, uint8_t buttons) {
+    // Mover o ponteiro so toca os retangulos antigo e novo do sprite.
+    video_cursor_move(x, y);
+
+    int pressed  = (buttons & 1) && !(g_prev_buttons & 1);
+    int released = !(buttons & 1) && (g_prev_buttons & 1);
+    g_prev_buttons = buttons;
+
+    if (pressed) {
+        Window* w = window_at(x, y);
+        if (!w) return 0;
+        int hit = window_hit(w, x, y);
+        if (hit == WINDOW_HIT_CLOSE) {
+            if (g_drag == w) g_drag = NULL;
+            window_close(w);
+            return 1;
+        }
+        window_focus(w);
+        if (hit == WINDOW_HIT_TITLE) {
+            int wx = 0, wy = 0;
+            window_get_pos(w, &wx, &wy);
+            g_drag = w;
+            g_drag_offx = x - wx;
+            g_drag_offy = y - wy;
+            g_drag_tx = wx;
+            g_drag_ty = wy;
+        }
+        return 1;
+    }
+
+    if (released) {
+        if (g_drag) window_move(g_drag, g_drag_tx, g_drag_ty);
+        int was = g_drag != NULL;
+        g_drag = NULL;
+        return was;
+    }
+
+    if (g_drag) {
+        g_drag_tx = x - g_drag_offx;
+        g_drag_ty = y - g_drag_offy;
+        return 1;
+    }
+    return 0;
+}
+
+// Loop principal do desktop: dorme na fila de eventos e só desenha quando
+// algum evento mudou o estado. Frames limitados a ~60 Hz; o cursor piscando
+// agenda o próprio timer. Não retorna.
+void desktop_run(void) {
+    desktop_init();
+
+    // Descarta o que chegou enquanto o console estava ativo.
+    event_t stale;
+    while (event_poll(&stale)) { }
+    keyboard_flush();
+
+    int need_redraw = 1;
+    uint32_t last_frame = time_get_ticks() - DESKTOP_FRAME_MS;
+
+    for (;;) {
+        event_t ev;
+        event_wait(&ev);
+        do {
+            switch (ev.type) {
+            case EVENT_KEY:
+                desktop_key((char)ev.key);
+                need_redraw = 1;
+                break;
+            case EVENT_MOUSE:
+                if (desktop_mouse(ev.x, ev.y, ev.buttons)) need_redraw = 1;
+                break;
+            case EVENT_TIMER:
+                need_redraw = 1;
+                break;
+            }
+        } while (event_poll(&ev));
+
+        // As teclas já chegaram pela fila; não deixa acumular no buffer do console.
+        keyboard_flush();
+
+        if (!need_redraw) continue;
+
+        uint32_t now = time_get_ticks();
+        if ((now - last_frame) < DESKTOP_FRAME_MS) {
+            event_timer_arm(last_frame + DESKTOP_FRAME_MS);
+            continue;
+        }
+        last_frame = now;
+        desktop_draw();
+        need_redraw = 0;
+    }
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: event.c
+ * Descricao: Fila de eventos do kernel (teclado, mouse, timer) alimentada pelas IRQs.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include "event.h"
+#include "irqflags.h"
+#include "time.h"
+#include "math.h"
+#include "timer.h"
+#include "idle.h"
+
+// Anel potencia de 2. Produtores rodam em IRQ ou em callbacks de timer (com
+// IRQs ligadas), entao postam com irq_save; o consumidor retira com
+// interrupcoes desligadas.
+#define EVENT_QUEUE_SIZE 256
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+static event_t g_queue[EVENT_QUEUE_SIZE];
+static volatile uint32_t g_head = 0;   // proximo a escrever
+static volatile uint32_t g_tail = 0;   // proximo a ler
+
+static ktimer_t* g_timer = 0;        // EVENT_TIMER armado (roda de timers)
+static uint32_t g_timer_deadline = 0;
+
+static event_t* queue_slot(void) {
+    if (g_head - g_tail >= EVENT_QUEUE_SIZE) return 0; // cheia: descarta
+    return &g_queue[g_head & EVENT_QUEUE_MASK];
+}
+
+static void queue_commit(void) {
+    g_head++;
+}
+
+static void post_simple(uint8_t type, uint8_t key) {
+    uint32_t flags = irq_save();
+    event_t* e = queue_slot();
+    if (e) {
+        e->type = type;
+        e->key = key;
+        e->buttons = 0;
+        e->x = e->y = e->dx = e->dy = 0;
+        e->time = time_get_ticks();
+        queue_commit();
+    }
+    irq_restore(flags);
+}
+
+void event_post_key(uint8_t ch) {
+    post_simple(EVENT_KEY, ch);
+}
+
+void event_post_timer(void) {
+    post_simple(EVENT_TIMER, 0);
+}
+
+void event_post_mouse(int32_t x, int32_t y, int32_t dx, int32_t dy, uint8_t buttons) {
+    uint32_t flags = irq_save();
+
+    // Coalesce: se o ultimo evento ainda nao lido e um movimento com os
+    // mesmos botoes, so atualiza a posicao (a UI quer o estado mais novo).
+    if (g_head != g_tail) {
+        event_t* last = &g_queue[(g_head - 1u) & EVENT_QUEUE_MASK];
+        if (last->type == EVENT_MOUSE && last->buttons == buttons) {
+            last->x = x;
+            last->y = y;
+            last->dx += dx;
+            last->dy += dy;
+            last->time = time_get_ticks();
+            irq_restore(flags);
+            return;
+        }
+    }
+
+    event_t* e = queue_slot();
+    if (e) {
+        e->type = EVENT_MOUSE;
+        e->key = 0;
+        e->buttons = buttons;
+        e->x = x; e->y = y;
+        e->dx = dx; e->dy = dy;
+        e->time = time_get_ticks();
+        queue_commit();
+    }
+    irq_restore(flags);
+}
+
+static void event_timer_fire(void* arg) {
+    (void)arg;
+    g_timer = 0;            // one-shot: o handle ja nao vale
+    event_post_timer();
+}
+
+void event_timer_arm(uint32_t deadline) {
+    uint32_t flags = irq_save();
+    if (deadline == 0) {
+        timer_cancel(g_timer);
+        g_timer = 0;
+    } else if (!g_timer || time_reached_u32(g_timer_deadline, deadline)) {
+        timer_cancel(g_timer);
+        g_timer_deadline = deadline;
+        g_timer = timer_add(deadline, event_timer_fire, 0);
+    }
+    irq_restore(flags);
+}
+
+int event_poll(event_t* out) {
+    uint32_t flags = irq_save();
+    if (g_head == g_tail) {
+        irq_restore(flags);
+        return 0;
+    }
+    *out = g_queue[g_tail & EVENT_QUEUE_MASK];
+    g_tail++;
+    irq_restore(flags);
+    return 1;
+}
+
+void event_wait(event_t* out) {
+    for (;;) {
+        __asm__ volatile("cli");
+        if (g_head != g_tail) {
+            *out = g_queue[g_tail & EVENT_QUEUE_MASK];
+            g_tail++;
+            __asm__ volatile("sti");
+            return;
+        }
+        // Fila vazia testada com IF=0: cpu_idle dorme sem perder IRQ
+        cpu_idle();
+    }
+}
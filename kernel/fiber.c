@@ -0,0 +1,211 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: fiber.c
+ * Descricao: Fibers cooperativas: varios fluxos com pilha propria dentro de um thread.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "fiber.h"
+#include "irqflags.h"
+#include "sched.h"
+#include "memory.h"
+#include "time.h"
+#include "timer.h"
+#include "idle.h"
+#include "delay.h"
+
+// Anel de um thread (thread_t.fibers). A raiz e o fluxo original do thread.
+typedef struct {
+    fiber_t root;
+    fiber_t* cur;
+    fiber_t* zombie;        // acabou; quem roda depois libera a pilha
+} fiber_ring_t;
+
+static fiber_ring_t* ring_peek(void) {
+    return (fiber_ring_t*)sched_current()->fibers;
+}
+
+static fiber_ring_t* ring_get(void) {
+    thread_t* t = sched_current();
+    if (t->fibers) return (fiber_ring_t*)t->fibers;
+
+    fiber_ring_t* r = (fiber_ring_t*)kmalloc((uint32_t)sizeof(fiber_ring_t));
+    if (!r) return 0;
+    r->root.esp = 0;
+    r->root.next = &r->root;
+    r->root.wait = 0;
+    r->root.fn = 0;
+    r->root.arg = 0;
+    r->root.stack = 0;
+    r->root.name = t->name;
+    r->root.switches = 0;
+    r->cur = &r->root;
+    r->zombie = 0;
+    t->fibers = r;
+    return r;
+}
+
+static int event_ready(fiber_event_t* ev) {
+    return ev->pending || (ev->poll && ev->poll());
+}
+
+// Proxima fiber pronta depois da atual (IF=0). A atual pode ja estar fora
+// do anel (fiber_exit): o 'next' dela continua valendo como ponto de partida.
+static fiber_t* pick(fiber_ring_t* r) {
+    fiber_t* start = r->cur->next;
+    fiber_t* f = start;
+    do {
+        if (f != r->cur && (!f->wait || event_ready(f->wait))) return f;
+        f = f->next;
+    } while (f != start);
+    return 0;
+}
+
+static void reap(fiber_ring_t* r) {
+    fiber_t* z = r->zombie;
+    if (!z) return;
+    r->zombie = 0;
+    kfree(z->stack);
+    kfree(z);
+}
+
+static void switch_to(fiber_ring_t* r, fiber_t* next) {
+    fiber_t* prev = r->cur;
+    r->cur = next;
+    next->switches++;
+    sched_switch(&prev->esp, next->esp);
+    reap(r);                    // de volta nesta fiber
+}
+
+static void fiber_exit(fiber_ring_t* r) __attribute__((noreturn));
+
+static void fiber_exit(fiber_ring_t* r) {
+    __asm__ volatile("cli");
+    fiber_t* self = r->cur;
+    fiber_t* p = self;
+    while (p->next != self) p = p->next;
+    p->next = self->next;
+    r->zombie = self;
+
+    // A raiz nunca sai do anel: em algum momento alguem fica pronto
+    for (;;) {
+        fiber_t* next = pick(r);
+        if (next) {
+            r->cur = next;
+            next->switches++;
+            sched_switch(&self->esp, next->esp);
+        }
+        cpu_idle();
+        __asm__ volatile("cli");
+    }
+}
+
+// Primeira instrucao de toda fiber nova (vem do 'ret' do sched_switch)
+static void fiber_start(void) {
+    fiber_ring_t* r = ring_peek();
+    reap(r);
+    __asm__ volatile("sti");
+    r->cur->fn(r->cur->arg);
+    fiber_exit(r);
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+fiber_t* fiber_create(const char* name, void (*fn)(void* arg), void* arg) {
+    if (!fn) return 0;
+    fiber_ring_t* r = ring_get();
+    if (!r) return 0;
+
+    fiber_t* f = (fiber_t*)kmalloc((uint32_t)sizeof(fiber_t));
+    if (!f) return 0;
+    // Topo alinhado em 16, como nas pilhas de thread
+    uint8_t* stack = (uint8_t*)kmalloc_aligned(FIBER_STACK_SIZE, 16);
+    if (!stack) { kfree(f); return 0; }
+
+    f->wait = 0;
+    f->fn = fn;
+    f->arg = arg;
+    f->stack = stack;
+    f->name = name;
+    f->switches = 0;
+
+    // Mesmo formato inicial das pilhas de thread (sched_switch)
+    uint32_t* sp = (uint32_t*)(stack + FIBER_STACK_SIZE);
+    *--sp = 0;                                  // retorno falso de fiber_start
+    *--sp = (uint32_t)(uintptr_t)fiber_start;
+    *--sp = 0;                                  // ebp
+    *--sp = 0;                                  // ebx
+    *--sp = 0;                                  // esi
+    *--sp = 0;                                  // edi
+    f->esp = sp;
+
+    uint32_t flags = irq_save();
+    f->next = r->cur->next;
+    r->cur->next = f;
+    irq_restore(flags);
+    return f;
+}
+
+fiber_t* fiber_current(void) {
+    fiber_ring_t* r = ring_peek();
+    return r ? r->cur : 0;
+}
+
+void fiber_yield(void) {
+    fiber_ring_t* r = ring_peek();
+    if (!r) return;
+    uint32_t flags = irq_save();
+    fiber_t* next = pick(r);
+    if (next) switch_to(r, next);
+    irq_restore(flags);
+}
+
+void fiber_wait(fiber_event_t* ev) {
+    fiber_ring_t* r = ring_peek();
+    for (;;) {
+        uint32_t flags = irq_save();
+        if (event_ready(ev)) {
+            ev->pending = 0;
+            irq_restore(flags);
+            return;
+        }
+        fiber_t* next = r ? pick(r) : 0;
+        if (next) {
+            r->cur->wait = ev;
+            switch_to(r, next);
+            r->cur->wait = 0;
+        } else {
+            cpu_idle();         // todas esperando: IF=0 aqui, volta com IF=1
+        }
+        irq_restore(flags);
+    }
+}
+
+void fiber_signal(fiber_event_t* ev) {
+    ev->pending = 1;
+}
+
+static void sleep_timeout(void* arg) {
+    fiber_signal((fiber_event_t*)arg);
+}
+
+void fiber_sleep_ms(uint32_t ms) {
+    fiber_event_t ev = FIBER_EVENT_INIT;
+    if (!timer_add(time_get_ticks() + ms, sleep_timeout, &ev)) {
+        delay_ms(ms);           // pool de timers cheio
+        return;
+    }
+    fiber_wait(&ev);
+}
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: fpu.c
+ * Descricao: Estado x87/SSE: init, regioes SIMD do kernel e troca preguicosa (#NM).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include "fpu.h"
+#include "irqflags.h"
+#include "cpu.h"
+
+#define CR0_MP (1u << 1)
+#define CR0_EM (1u << 2)
+#define CR0_TS (1u << 3)
+#define CR0_NE (1u << 5)
+#define CR4_OSFXSR     (1u << 9)
+#define CR4_OSXMMEXCPT (1u << 10)
+
+static int g_ok = 0;
+static int g_fxsr = 0;
+
+// Estado limpo (FNINIT + MXCSR padrao), copiado para contextos novos.
+static fpu_state_t g_clean;
+
+// Contexto do boot: o laco principal e tudo que roda fora de fpu_switch().
+static fpu_state_t g_boot;
+
+// g_current: contexto em execucao. g_owner: de quem sao os registradores
+// agora (NULL = rascunho, ninguem perde nada se forem sobrescritos).
+static fpu_state_t* g_current = &g_boot;
+static fpu_state_t* g_owner = &g_boot;
+
+// Regioes do kernel aninhadas: g_nest[d] guarda o nivel d-1 interrompido.
+static volatile int g_depth = 0;
+static fpu_state_t g_nest[FPU_NEST_MAX];
+
+static inline uint32_t read_cr0(void) {
+    uint32_t v;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(v));
+    return v;
+}
+
+static inline void write_cr0(uint32_t v) {
+    __asm__ volatile("mov %0, %%cr0" :: "r"(v) : "memory");
+}
+
+static inline void clts(void) {
+    __asm__ volatile("clts" ::: "memory");
+}
+
+static inline void stts(void) {
+    write_cr0(read_cr0() | CR0_TS);
+}
+
+// Sem FXSR (pre-PII) cai no FNSAVE/FRSTOR: 108 bytes, cabem na mesma area.
+static inline void fpu_save(fpu_state_t* st) {
+    if (g_fxsr) __asm__ volatile("fxsave %0" : "=m"(st->area));
+    else        __asm__ volatile("fnsave %0; fwait" : "=m"(st->area));
+}
+
+static inline void fpu_restore(const fpu_state_t* st) {
+    if (g_fxsr) __asm__ volatile("fxrstor %0" :: "m"(st->area));
+    else        __asm__ volatile("frstor %0" :: "m"(st->area));
+}
+
+void fpu_init(void) {
+    if (!cpu_has(CPU_FPU)) return;
+    g_fxsr = cpu_has(CPU_FXSR);
+
+    uint32_t cr0 = read_cr0();
+    cr0 &= ~(CR0_EM | CR0_TS);
+    cr0 |= CR0_MP | CR0_NE;
+    write_cr0(cr0);
+
+    if (g_fxsr) {
+        uint32_t cr4;
+        __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+        cr4 |= CR4_OSFXSR;
+        if (cpu_has(CPU_SSE)) cr4 |= CR4_OSXMMEXCPT;
+        __asm__ volatile("mov %0, %%cr4" :: "r"(cr4));
+    }
+
+    __asm__ volatile("fninit");
+    if (cpu_has(CPU_SSE)) {
+        uint32_t mxcsr = 0x1F80u;   // todas as excecoes mascaradas, arredonda p/ mais proximo
+        __asm__ volatile("ldmxcsr %0" :: "m"(mxcsr));
+    }
+    fpu_save(&g_clean);
+    if (!g_fxsr) __asm__ volatile("fninit");   // FNSAVE reinicia a FPU
+    g_clean.used = 1;
+
+    g_boot.used = 1;
+    g_current = &g_boot;
+    g_owner = &g_boot;
+    g_ok = 1;
+}
+
+int fpu_present(void) {
+    return g_ok;
+}
+
+void fpu_state_init(fpu_state_t* st) {
+    st->used = 0;
+}
+
+void fpu_switch(fpu_state_t* next) {
+    if (!g_ok || next == g_current) return;
+    g_current = next;
+    if (g_owner != next) stts();
+    else                 clts();
+}
+
+int fpu_handle_nm(void) {
+    if (!g_ok) return 0;
+    clts();
+    if (g_owner == g_current) return 1;
+    if (g_owner) fpu_save(g_owner);
+    fpu_restore(g_current->used ? g_current : &g_clean);
+    g_current->used = 1;
+    g_owner = g_current;
+    return 1;
+}
+
+void kernel_fpu_begin(void) {
+    if (!g_ok) return;
+    uint32_t flags = irq_save();
+    int d = g_depth;
+    clts();
+    if (d == 0) {
+        // Tira o dono: o estado dele fica salvo e volta no proximo #NM.
+        if (g_owner) { fpu_save(g_owner); g_owner = 0; }
+    } else if (d < FPU_NEST_MAX) {
+        fpu_save(&g_nest[d]);
+    }
+    g_depth = d + 1;
+    irq_restore(flags);
+}
+
+void kernel_fpu_end(void) {
+    if (!g_ok) return;
+    uint32_t flags = irq_save();
+    int d = g_depth - 1;
+    g_depth = d;
+    if (d == 0) {
+        // Registradores sao rascunho: o proximo uso normal recarrega via #NM.
+        stts();
+    } else if (d < FPU_NEST_MAX) {
+        fpu_restore(&g_nest[d]);
+    }
+    irq_restore(flags);
+}
+
+int kernel_fpu_usable(void) {
+    return g_ok && g_depth < FPU_NEST_MAX;
+}
+
+int kernel_fpu_active(void) {
+    return g_depth != 0;
+}
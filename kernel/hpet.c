@@ -0,0 +1,217 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: hpet.c
+ * Descricao: HPET (clocksource e clockevent)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "hpet.h"
+#include "acpi.h"
+#include "clock.h"
+#include "tick.h"
+#include "math.h"
+
+// Registradores (offset do MMIO)
+#define HPET_CAP        0x000   // lo: rev/timers/flags, hi: periodo em fs
+#define HPET_CONF       0x010
+#define HPET_COUNTER    0x0F0
+#define HPET_T0_CONF    0x100
+#define HPET_T0_CMP     0x108
+
+#define CAP_COUNT_64    (1u << 13)
+#define CONF_ENABLE     (1u << 0)
+#define CONF_LEGACY     (1u << 1)   // T0 -> IRQ0, T1 -> IRQ8
+
+#define TN_INT_ENB      (1u << 2)
+#define TN_PERIODIC     (1u << 3)
+#define TN_PER_CAP      (1u << 4)
+#define TN_VAL_SET      (1u << 6)
+#define TN_32MODE       (1u << 8)
+
+#define FS_PER_SEC      1000000000000000ull
+#define MAX_PERIOD_FS   100000000u      // limite da especificacao (100ns)
+
+typedef struct {
+    acpi_sdt_t h;
+    uint32_t block_id;
+    uint8_t  space_id;          // 0 = memoria
+    uint8_t  bit_width;
+    uint8_t  bit_offset;
+    uint8_t  access_size;
+    uint32_t addr_lo;
+    uint32_t addr_hi;
+    uint8_t  number;
+    uint16_t min_tick;
+    uint8_t  page_prot;
+} __attribute__((packed)) acpi_hpet_t;
+
+static volatile uint32_t* g_hpet = 0;
+static uint64_t g_freq = 0;
+
+static inline uint32_t hpet_rd(uint32_t reg) {
+    return g_hpet[reg / 4];
+}
+
+static inline void hpet_wr(uint32_t reg, uint32_t v) {
+    g_hpet[reg / 4] = v;
+}
+
+uint64_t hpet_read(void) {
+    // Contador de 64 bits lido em duas metades: repete se a alta mudou
+    uint32_t hi, lo;
+    do {
+        hi = hpet_rd(HPET_COUNTER + 4);
+        lo = hpet_rd(HPET_COUNTER);
+    } while (hi != hpet_rd(HPET_COUNTER + 4));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+uint64_t hpet_freq_hz(void) {
+    return g_freq;
+}
+
+static clocksource_t g_hpet_cs = {
+    .name = "hpet",
+    .read = hpet_read,
+    .rating = CLOCK_RATING_HPET,
+};
+
+// ---------------------------------------------------------------------------
+// Comparador 0 como clockevent
+// ---------------------------------------------------------------------------
+
+static uint32_t g_ev_mult = 0;          // ticks = (ns * mult) >> shift
+static uint32_t g_ev_shift = 0;
+static uint32_t g_t0_conf = 0;          // bits fixos do T0 (32 bits, edge)
+static int g_legacy = 0;                // CONF_LEGACY ligado: o RTC perde o IRQ8
+
+// Roteamento legado: T0 entra no IRQ0 (8259 ou GSI2 no I/O APIC) no lugar do
+// PIT, e o timer_irq atende igual. Custa o IRQ8 (vai para o T1), entao so
+// liga quando o tick de fato programa o HPET e desliga no shutdown.
+static void hpet_legacy(int on) {
+    if (on == g_legacy) return;
+    uint32_t conf = hpet_rd(HPET_CONF);
+    hpet_wr(HPET_CONF, on ? (conf | CONF_LEGACY) : (conf & ~CONF_LEGACY));
+    g_legacy = on;
+}
+
+static void hpet_ev_periodic(uint32_t hz) {
+    uint32_t period = (uint32_t)udiv64(g_freq, hz ? hz : 1000u, 0);
+    if (period == 0) period = 1;
+
+    hpet_legacy(1);
+    // Com VAL_SET a primeira escrita arma o prazo, a segunda o periodo
+    hpet_wr(HPET_T0_CONF, g_t0_conf | TN_INT_ENB | TN_PERIODIC | TN_VAL_SET);
+    hpet_wr(HPET_T0_CMP, hpet_rd(HPET_COUNTER) + period);
+    hpet_wr(HPET_T0_CMP, period);
+}
+
+static void hpet_ev_oneshot(uint32_t delta_ns) {
+    uint32_t delta = (uint32_t)mul_u64_u32_shr(delta_ns, g_ev_mult, g_ev_shift);
+    if (delta < 1) delta = 1;
+
+    hpet_legacy(1);
+    hpet_wr(HPET_T0_CONF, g_t0_conf | TN_INT_ENB);
+
+    // Comparador por igualdade: se o contador ja passou do prazo ao escrever,
+    // o IRQ so viria na volta dos 32 bits. Confere e tenta com prazo maior.
+    for (;;) {
+        uint32_t cmp = hpet_rd(HPET_COUNTER) + delta;
+        hpet_wr(HPET_T0_CMP, cmp);
+        if ((int32_t)(cmp - hpet_rd(HPET_COUNTER)) > 0) break;
+        delta <<= 1;
+    }
+}
+
+static void hpet_ev_shutdown(void) {
+    hpet_wr(HPET_T0_CONF, g_t0_conf);
+    hpet_legacy(0);
+}
+
+static clockevent_t g_hpet_ce = {
+    .name = "hpet",
+    .rating = CLOCKEVENT_RATING_HPET,
+    .set_periodic = hpet_ev_periodic,
+    .set_oneshot = hpet_ev_oneshot,
+    .shutdown = hpet_ev_shutdown,
+};
+
+static void hpet_ev_init(void) {
+    uint32_t t0 = hpet_rd(HPET_T0_CONF);
+    if (!(t0 & TN_PER_CAP)) return;
+
+    // Maior shift em que mult = freq * 2^shift / 1e9 cabe em 32 bits
+    uint32_t shift = 32;
+    uint64_t m = 0;
+    for (; shift > 0; shift--) {
+        m = udiv64(g_freq << shift, 1000000000ull, 0);
+        if (m <= 0xFFFFFFFFull) break;
+    }
+    g_ev_mult = (uint32_t)m;
+    g_ev_shift = shift;
+
+    // Prazo cabe em 31 bits (comparacao com sinal), limitado a 1s
+    uint64_t max_ns = udiv64(0x7FFFFFFFull * 1000000000ull, g_freq, 0);
+    g_hpet_ce.max_delta_ns = (max_ns > 1000000000ull) ? 1000000000u : (uint32_t)max_ns;
+    g_hpet_ce.min_delta_ns = (uint32_t)udiv64(4000000000ull, g_freq, 0) + 1000u;
+
+    // T0 em 32 bits e por borda: a escrita do comparador e atomica
+    g_t0_conf = TN_32MODE;
+    hpet_wr(HPET_T0_CONF, g_t0_conf);
+
+    // Se o timer do LAPIC ja e o tick, o HPET fica so como clocksource e o
+    // roteamento legado nunca e ligado.
+    tick_register(&g_hpet_ce);
+}
+
+int hpet_owns_irq8(void) {
+    return g_legacy;
+}
+
+// ---------------------------------------------------------------------------
+// Init
+// ---------------------------------------------------------------------------
+
+int hpet_init(void) {
+    if (g_hpet) return 1;
+
+    if (!acpi_init()) return 0;
+    const acpi_hpet_t* t = (const acpi_hpet_t*)acpi_find_table("HPET");
+    if (!t || t->h.length < sizeof(acpi_hpet_t)) return 0;
+    if (t->space_id != 0 || t->addr_hi != 0 || t->addr_lo == 0) return 0;
+
+    g_hpet = (volatile uint32_t*)(uintptr_t)t->addr_lo;
+
+    uint32_t period = hpet_rd(HPET_CAP + 4);
+    uint32_t cap = hpet_rd(HPET_CAP);
+
+    // Sem contador de 64 bits o clocksource precisaria de extensao por
+    // software (volta em segundos): nao usa.
+    if (period == 0 || period > MAX_PERIOD_FS || !(cap & CAP_COUNT_64)) {
+        g_hpet = 0;
+        return 0;
+    }
+    g_freq = udiv64(FS_PER_SEC, period, 0);
+
+    // Para, zera e liga o contador principal
+    hpet_wr(HPET_CONF, hpet_rd(HPET_CONF) & ~(CONF_ENABLE | CONF_LEGACY));
+    hpet_wr(HPET_COUNTER, 0);
+    hpet_wr(HPET_COUNTER + 4, 0);
+    hpet_wr(HPET_CONF, hpet_rd(HPET_CONF) | CONF_ENABLE);
+
+    g_hpet_cs.freq_hz = g_freq;
+    clock_register(&g_hpet_cs);
+
+    hpet_ev_init();
+    return 1;
+}
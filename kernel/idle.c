@@ -0,0 +1,193 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: idle.c
+ * Descricao: Laco ocioso central (MWAIT/HLT), trabalho em tempo ocioso e contabilidade.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include "idle.h"
+#include "irqflags.h"
+#include "cpu.h"
+#include "clock.h"
+#include "softirq.h"
+#include "sched.h"
+
+#define WINDOW_NS 1000000000ull
+
+// 0 = HLT, 1 = MWAIT, 2 = MWAIT que acorda com IF=0 (a hora de acordar e
+// lida antes do handler da IRQ rodar, entao o handler conta como ocupado)
+static int g_mode = 0;
+
+// Linha monitorada pelo MONITOR: escrever nela tambem acorda o MWAIT
+static volatile uint32_t g_wake_word __attribute__((aligned(64)));
+
+static idle_work_t* g_work = 0;
+// Uma passada sem nada para fazer: a proxima chamada dorme direto
+static int g_work_quiet = 0;
+
+// Janela de 1s: ocioso acumulado na janela corrente e o resultado da ultima
+static uint64_t g_boot_ns = 0;
+static uint64_t g_idle_total = 0;
+static uint64_t g_win_start = 0;
+static uint64_t g_win_idle = 0;
+static uint32_t g_win_wakeups = 0;
+static uint64_t g_last_idle = 0;
+static uint32_t g_last_wakeups = 0;
+static uint32_t g_wakeups_total = 0;
+
+// Inicio do halt em curso (0 = fora do halt)
+static uint64_t g_halt_t0 = 0;
+
+void idle_init(void) {
+    if (cpu_has(CPU_MONITOR)) g_mode = cpu_has(CPU_MWAIT_IRQ) ? 2 : 1;
+    g_boot_ns = clock_ns();
+    g_win_start = g_boot_ns;
+}
+
+const char* idle_method(void) {
+    return g_mode == 2 ? "mwait (break on irq)" : g_mode == 1 ? "mwait" : "hlt";
+}
+
+// Fecha as janelas de 1s que terminaram ate 'now'. Com IF=0.
+static void roll(uint64_t now) {
+    if (now - g_win_start >= 2 * WINDOW_NS) {
+        // Ficou mais de uma janela inteira sem passar por aqui: ocupado
+        g_last_idle = 0;
+        g_last_wakeups = 0;
+        g_win_start = now;
+        g_win_idle = 0;
+        g_win_wakeups = 0;
+        return;
+    }
+    if (now - g_win_start >= WINDOW_NS) {
+        g_last_idle = g_win_idle;
+        g_last_wakeups = g_win_wakeups;
+        g_win_start += WINDOW_NS;
+        g_win_idle = 0;
+        g_win_wakeups = 0;
+    }
+}
+
+// Intervalo ocioso [t0, t1], dividido nas janelas que ele atravessa.
+static void account(uint64_t t0, uint64_t t1) {
+    roll(t0);
+    g_idle_total += t1 - t0;
+    g_wakeups_total++;
+    while (t1 - g_win_start >= WINDOW_NS) {
+        uint64_t end = g_win_start + WINDOW_NS;
+        if (t0 < end) {
+            g_win_idle += end - t0;
+            t0 = end;
+        }
+        g_last_idle = g_win_idle;
+        g_last_wakeups = g_win_wakeups;
+        g_win_start = end;
+        g_win_idle = 0;
+        g_win_wakeups = 0;
+    }
+    g_win_idle += t1 - t0;
+    g_win_wakeups++;
+}
+
+// Fecha o halt em curso em 'now'. Com IF=0. Se a IRQ que acordou a CPU
+// trocou de thread, o escalonador ja fechou (idle_leave) e aqui nao conta.
+static void idle_close(uint64_t now) {
+    if (!g_halt_t0) return;
+    account(g_halt_t0, now);
+    g_halt_t0 = 0;
+}
+
+static int run_idle_work(void) {
+    int did = 0;
+    for (idle_work_t* w = g_work; w; w = w->next) {
+        if (w->fn(w->arg)) {
+            w->runs++;
+            did = 1;
+        }
+    }
+    return did;
+}
+
+static inline void halt(void) {
+    if (g_mode == 0) {
+        // sti so vale depois da proxima instrucao: nenhuma IRQ escapa
+        __asm__ volatile("sti; hlt" ::: "memory");
+        return;
+    }
+    __asm__ volatile("monitor" :: "a"(&g_wake_word), "c"(0), "d"(0));
+    if (g_mode == 2) {
+        // ECX bit 0: a IRQ acorda mesmo mascarada; o sti vem do chamador
+        __asm__ volatile("mwait" :: "a"(0), "c"(1) : "memory");
+    } else {
+        __asm__ volatile("sti; mwait" :: "a"(0), "c"(0) : "memory");
+    }
+}
+
+void cpu_idle(void) {
+    if (softirq_pending()) {
+        __asm__ volatile("sti");
+        softirq_run();
+        return;
+    }
+    // Com threads: dorme so este thread ate a proxima IRQ; o ocioso e quem
+    // roda o trabalho em tempo ocioso e para a CPU.
+    if (sched_wait_irq()) return;
+    if (g_work && !g_work_quiet) {
+        // Rodou com IF=1: o que o chamador espera pode ter chegado no meio,
+        // entao volta para ele testar antes de dormir.
+        __asm__ volatile("sti");
+        if (!run_idle_work()) g_work_quiet = 1;
+        return;
+    }
+
+    g_halt_t0 = g_boot_ns ? clock_ns() : 0;  // antes do idle_init nao conta
+    halt();
+    uint64_t t1 = clock_ns();
+    __asm__ volatile("cli");
+    idle_close(t1);
+    g_work_quiet = 0;
+    __asm__ volatile("sti");
+}
+
+void idle_leave(void) {
+    idle_close(clock_ns());
+}
+
+void idle_register(idle_work_t* w) {
+    uint32_t flags = irq_save();
+    w->runs = 0;
+    w->next = 0;
+    idle_work_t** p = &g_work;
+    while (*p) p = &(*p)->next;
+    *p = w;
+    g_work_quiet = 0;
+    irq_restore(flags);
+}
+
+idle_work_t* idle_work_list(void) {
+    return g_work;
+}
+
+void idle_stats(idle_stats_t* out) {
+    uint64_t now = clock_ns();
+    uint32_t flags = irq_save();
+    roll(now);
+    uint64_t idle = g_last_idle;
+    out->wakeups = g_last_wakeups;
+    out->idle_ns = g_idle_total;
+    out->total_ns = now - g_boot_ns;
+    out->wakeups_total = g_wakeups_total;
+    irq_restore(flags);
+
+    if (idle > WINDOW_NS) idle = WINDOW_NS;
+    out->busy_pm = 1000u - (uint32_t)idle / 1000000u;
+}
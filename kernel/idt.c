@@ -15,6 +15,8 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include "idt.h"
+#include "smp.h"
 
 // Exception stubs (boot/interrupts.s)
 extern void isr0(void);
@@ -67,6 +69,10 @@ extern void irq12(void);
 extern void irq13(void);
 extern void irq14(void);
 extern void irq15(void);
+extern void irq_spurious(void);
+extern void irq_ipi_call(void);
+extern void irq_bench_fast(void);
+extern void irq_bench_slow(void);
 
 // Fallback handler (boot/isr_halt.s)
 extern void isr_halt(void);
@@ -155,6 +161,21 @@ void idt_init(void) {
     idt_set_gate(46, (uint32_t)(uintptr_t)&irq14, 0x08, 0x8E);
     idt_set_gate(47, (uint32_t)(uintptr_t)&irq15, 0x08, 0x8E);
 
+    // irqstat bench: o mesmo handler pelo caminho rapido e pelo completo
+    idt_set_gate(0x30, (uint32_t)(uintptr_t)&irq_bench_fast, 0x08, 0x8E);
+    idt_set_gate(0x31, (uint32_t)(uintptr_t)&irq_bench_slow, 0x08, 0x8E);
+
+    // IPI de chamada entre CPUs (smp.h)
+    idt_set_gate(SMP_IPI_VECTOR, (uint32_t)(uintptr_t)&irq_ipi_call, 0x08, 0x8E);
+
+    // Vetor espurio do LAPIC (apic.h)
+    idt_set_gate(0xFF, (uint32_t)(uintptr_t)&irq_spurious, 0x08, 0x8E);
+
+    idt_load();
+}
+
+// Mesma IDT em todas as CPUs (os APs carregam no smp.c)
+void idt_load(void) {
     struct idt_ptr idtp;
     idtp.limit = (uint16_t)(sizeof(idt) - 1);
     idtp.base  = (uint32_t)(uintptr_t)&idt[0];
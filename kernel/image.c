@@ -0,0 +1,319 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: image.c
+ * Descricao: Decodificadores QOI/BMP em streaming (linha a linha) e escala.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include "image.h"
+#include "memory.h"
+
+#define IMAGE_MAX_DIM 16384
+
+static inline uint32_t rd_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint32_t rd_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t rd_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// ---------------------------------------------------------------------------
+// QOI (https://qoiformat.org) - o estado do decoder atravessa as linhas,
+// entao a imagem sai em ordem sem buffer alem de uma linha.
+// ---------------------------------------------------------------------------
+
+#define QOI_HEADER   14
+#define QOI_PADDING  8
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xC0
+#define QOI_OP_RGB   0xFE
+#define QOI_OP_RGBA  0xFF
+#define QOI_MASK_2   0xC0
+
+static int qoi_probe(const uint8_t* d, uint32_t len, int* w, int* h) {
+    if (len < QOI_HEADER + QOI_PADDING) return 0;
+    if (d[0] != 'q' || d[1] != 'o' || d[2] != 'i' || d[3] != 'f') return 0;
+    uint32_t ww = rd_be32(d + 4), hh = rd_be32(d + 8);
+    if (ww == 0 || hh == 0 || ww > IMAGE_MAX_DIM || hh > IMAGE_MAX_DIM) return 0;
+    if (d[12] < 3 || d[12] > 4) return 0;
+    *w = (int)ww; *h = (int)hh;
+    return 1;
+}
+
+static int qoi_decode(const uint8_t* d, uint32_t len, int w, int h,
+                      uint32_t* row, image_row_fn fn, void* ctx) {
+    uint32_t index[64];
+    for (int i = 0; i < 64; i++) index[i] = 0;
+
+    uint8_t r = 0, g = 0, b = 0, a = 255;
+    uint32_t pos = QOI_HEADER;
+    uint32_t end = len - QOI_PADDING;
+    int run = 0;
+
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (run > 0) {
+                run--;
+            } else if (pos < end) {
+                uint8_t b1 = d[pos++];
+                if (b1 == QOI_OP_RGB) {
+                    if (pos + 3 > end) return 0;
+                    r = d[pos]; g = d[pos + 1]; b = d[pos + 2];
+                    pos += 3;
+                } else if (b1 == QOI_OP_RGBA) {
+                    if (pos + 4 > end) return 0;
+                    r = d[pos]; g = d[pos + 1]; b = d[pos + 2]; a = d[pos + 3];
+                    pos += 4;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+                    uint32_t px = index[b1];
+                    a = (uint8_t)(px >> 24); r = (uint8_t)(px >> 16);
+                    g = (uint8_t)(px >> 8);  b = (uint8_t)px;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+                    r = (uint8_t)(r + ((b1 >> 4) & 3) - 2);
+                    g = (uint8_t)(g + ((b1 >> 2) & 3) - 2);
+                    b = (uint8_t)(b + (b1 & 3) - 2);
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+                    if (pos + 1 > end) return 0;
+                    uint8_t b2 = d[pos++];
+                    int vg = (b1 & 0x3F) - 32;
+                    r = (uint8_t)(r + vg - 8 + ((b2 >> 4) & 0x0F));
+                    g = (uint8_t)(g + vg);
+                    b = (uint8_t)(b + vg - 8 + (b2 & 0x0F));
+                } else {
+                    run = b1 & 0x3F;
+                }
+                index[(r * 3 + g * 5 + b * 7 + a * 11) & 63] =
+                    ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+            } else {
+                return 0; // dados acabaram antes da hora
+            }
+            row[x] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+        }
+        fn(ctx, y, row, w);
+    }
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// BMP sem compressao (24/32bpp, BI_RGB ou BI_BITFIELDS). Linhas sao lidas
+// direto do modulo na ordem certa (bottom-up ou top-down).
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t off;
+    int w, h;
+    int top_down;
+    int bpp;
+    uint32_t stride;
+    int rs, gs, bs;     // shifts dos canais (32bpp)
+} bmp_info_t;
+
+static int mask_shift(uint32_t m) {
+    if (!m) return -1;
+    int s = 0;
+    while (!(m & 1u)) { m >>= 1; s++; }
+    return (m == 0xFFu) ? s : -1;   // so canais de 8 bits
+}
+
+static int bmp_parse(const uint8_t* d, uint32_t len, bmp_info_t* bi) {
+    if (len < 54 || d[0] != 'B' || d[1] != 'M') return 0;
+    uint32_t off = rd_le32(d + 10);
+    uint32_t hdr = rd_le32(d + 14);
+    if (hdr < 40 || 14 + hdr > len) return 0;
+
+    int32_t w = (int32_t)rd_le32(d + 18);
+    int32_t h = (int32_t)rd_le32(d + 22);
+    uint16_t planes = rd_le16(d + 26);
+    uint16_t bpp = rd_le16(d + 28);
+    uint32_t comp = rd_le32(d + 30);
+
+    if (planes != 1 || (bpp != 24 && bpp != 32)) return 0;
+    bi->top_down = (h < 0);
+    if (h < 0) h = -h;
+    if (w <= 0 || h <= 0 || w > IMAGE_MAX_DIM || h > IMAGE_MAX_DIM) return 0;
+
+    bi->rs = 16; bi->gs = 8; bi->bs = 0;
+    if (comp == 3 && bpp == 32) {
+        // BI_BITFIELDS: mascaras logo apos o header de 40 bytes
+        if (14 + 40 + 12 > len) return 0;
+        bi->rs = mask_shift(rd_le32(d + 54));
+        bi->gs = mask_shift(rd_le32(d + 58));
+        bi->bs = mask_shift(rd_le32(d + 62));
+        if (bi->rs < 0 || bi->gs < 0 || bi->bs < 0) return 0;
+    } else if (comp != 0) {
+        return 0;
+    }
+
+    bi->off = off;
+    bi->w = w; bi->h = h;
+    bi->bpp = bpp;
+    bi->stride = (((uint32_t)w * bpp + 31u) / 32u) * 4u;
+    if (off > len || bi->stride * (uint32_t)h > len - off) return 0;
+    return 1;
+}
+
+static int bmp_decode(const uint8_t* d, const bmp_info_t* bi,
+                      uint32_t* row, image_row_fn fn, void* ctx) {
+    for (int y = 0; y < bi->h; y++) {
+        int fy = bi->top_down ? y : (bi->h - 1 - y);
+        const uint8_t* p = d + bi->off + (uint32_t)fy * bi->stride;
+        if (bi->bpp == 24) {
+            for (int x = 0; x < bi->w; x++, p += 3) {
+                row[x] = ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+            }
+        } else {
+            for (int x = 0; x < bi->w; x++, p += 4) {
+                uint32_t v = rd_le32(p);
+                row[x] = (((v >> bi->rs) & 0xFFu) << 16) | (((v >> bi->gs) & 0xFFu) << 8) | ((v >> bi->bs) & 0xFFu);
+            }
+        }
+        fn(ctx, y, row, bi->w);
+    }
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+
+int image_probe(const uint8_t* data, uint32_t len, int* w, int* h) {
+    int ww = 0, hh = 0;
+    if (!data) return IMAGE_NONE;
+    if (qoi_probe(data, len, &ww, &hh)) {
+        if (w) *w = ww;
+        if (h) *h = hh;
+        return IMAGE_QOI;
+    }
+    bmp_info_t bi;
+    if (bmp_parse(data, len, &bi)) {
+        if (w) *w = bi.w;
+        if (h) *h = bi.h;
+        return IMAGE_BMP;
+    }
+    return IMAGE_NONE;
+}
+
+int image_decode(const uint8_t* data, uint32_t len, uint32_t* rowbuf,
+                 image_row_fn fn, void* ctx) {
+    int w = 0, h = 0;
+    if (!rowbuf || !fn) return 0;
+    if (qoi_probe(data, len, &w, &h)) return qoi_decode(data, len, w, h, rowbuf, fn, ctx);
+
+    bmp_info_t bi;
+    if (bmp_parse(data, len, &bi)) return bmp_decode(data, &bi, rowbuf, fn, ctx);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Escala em streaming. Cada linha de origem chega uma vez; as linhas de
+// destino que dependem dela saem na hora. Bilinear guarda so a linha anterior.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t* dst;
+    int dst_w, dst_h, dst_stride;
+    int src_w, src_h;
+    int filter;
+    uint32_t step_x, step_y;    // 16.16
+    int next_dy;                // proxima linha de destino a produzir
+    uint32_t* prev;             // linha src anterior (bilinear)
+} scale_ctx_t;
+
+static inline uint32_t lerp_px(uint32_t a, uint32_t b, uint32_t t) {
+    // t em 0..256
+    uint32_t rb = ((a & 0x00FF00FFu) * (256u - t) + (b & 0x00FF00FFu) * t) >> 8;
+    uint32_t g  = ((a & 0x0000FF00u) * (256u - t) + (b & 0x0000FF00u) * t) >> 8;
+    return (rb & 0x00FF00FFu) | (g & 0x0000FF00u);
+}
+
+static void scale_row_nearest(scale_ctx_t* s, uint32_t* out, const uint32_t* src) {
+    uint32_t fx = 0;
+    for (int x = 0; x < s->dst_w; x++, fx += s->step_x) out[x] = src[fx >> 16];
+}
+
+static void scale_row_bilinear(scale_ctx_t* s, uint32_t* out,
+                               const uint32_t* r0, const uint32_t* r1, uint32_t ty) {
+    uint32_t fx = 0;
+    int last = s->src_w - 1;
+    for (int x = 0; x < s->dst_w; x++, fx += s->step_x) {
+        int x0 = (int)(fx >> 16);
+        int x1 = (x0 < last) ? x0 + 1 : last;
+        uint32_t tx = (fx >> 8) & 0xFFu;
+        uint32_t top = lerp_px(r0[x0], r0[x1], tx);
+        uint32_t bot = lerp_px(r1[x0], r1[x1], tx);
+        out[x] = lerp_px(top, bot, ty);
+    }
+}
+
+static void scale_row_cb(void* ctx, int y, const uint32_t* row, int w) {
+    scale_ctx_t* s = (scale_ctx_t*)ctx;
+    (void)w;
+
+    while (s->next_dy < s->dst_h) {
+        uint32_t fy = (uint32_t)s->next_dy * s->step_y;
+        int y0 = (int)(fy >> 16);
+        uint32_t* out = s->dst + (uint32_t)s->next_dy * (uint32_t)s->dst_stride;
+
+        if (s->filter == IMAGE_SCALE_BILINEAR && s->prev) {
+            int y1 = (y0 < s->src_h - 1) ? y0 + 1 : y0;
+            if (y1 > y) break;                          // ainda nao chegou
+            const uint32_t* r0 = (y0 == y) ? row : s->prev;
+            scale_row_bilinear(s, out, r0, row, (fy >> 8) & 0xFFu);
+        } else {
+            if (y0 > y) break;
+            scale_row_nearest(s, out, row);
+        }
+        s->next_dy++;
+    }
+
+    if (s->prev) {
+        for (int x = 0; x < s->src_w; x++) s->prev[x] = row[x];
+    }
+}
+
+int image_decode_scaled(const uint8_t* data, uint32_t len,
+                        uint32_t* dst, int dst_w, int dst_h, int dst_stride,
+                        int filter) {
+    int sw = 0, sh = 0;
+    if (!dst || dst_w <= 0 || dst_h <= 0) return 0;
+    if (image_probe(data, len, &sw, &sh) == IMAGE_NONE) return 0;
+
+    scale_ctx_t s;
+    s.dst = dst;
+    s.dst_w = dst_w; s.dst_h = dst_h; s.dst_stride = dst_stride;
+    s.src_w = sw; s.src_h = sh;
+    s.filter = filter;
+    // sw/sh <= IMAGE_MAX_DIM (2^14): o 16.16 cabe em 32 bits.
+    s.step_x = ((uint32_t)sw << 16) / (uint32_t)dst_w;
+    s.step_y = ((uint32_t)sh << 16) / (uint32_t)dst_h;
+    s.next_dy = 0;
+    s.prev = 0;
+
+    uint32_t* rowbuf = (uint32_t*)kmalloc((uint32_t)sw * 4u);
+    if (!rowbuf) return 0;
+    if (filter == IMAGE_SCALE_BILINEAR) {
+        s.prev = (uint32_t*)kmalloc((uint32_t)sw * 4u);  // sem memoria: cai para nearest
+    }
+
+    int ok = image_decode(data, len, rowbuf, scale_row_cb, &s);
+
+    if (s.prev) kfree(s.prev);
+    kfree(rowbuf);
+    return ok && s.next_dy == dst_h;
+}
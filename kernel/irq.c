@@ -17,38 +17,149 @@
 
 #include <stdint.h>
 #include "irq.h"
+#include "irqflags.h"
 #include "pic.h"
+#include "apic.h"
+#include "timer.h"
+#include "softirq.h"
+#include "irqstat.h"
+#include "time.h"
+#include "sched.h"
 
 #define IRQ_COUNT 16
+#define IRQ_BENCH IRQ_COUNT        // vetor 0x30 do irqbench (sem EOI)
 
-static irq_handler_t irq_handlers[IRQ_COUNT];
+// Handler por vetor, chamado direto pelo irq_fast (boot/interrupts.s):
+// o handler unico da linha, irq_chain se ha mais de um, ou irq_none.
+irq_handler_t irq_vector_table[IRQ_COUNT + 1];
+
+static irq_action_t g_primary[IRQ_COUNT];     // irq_install_handler
+static irq_action_t* g_actions[IRQ_COUNT];
+
+static void irq_none(regs_t *r) {
+    (void)r;
+}
+
+// Linha compartilhada: todos os handlers, na ordem em que entraram
+static void irq_chain(regs_t *r) {
+    for (irq_action_t* a = g_actions[r->int_no - PIC1_OFFSET]; a; a = a->next) {
+        a->handler(r);
+    }
+}
+
+static void update_vector(uint8_t irq) {
+    irq_action_t* a = g_actions[irq];
+    if (!a) irq_vector_table[irq] = irq_none;
+    else if (!a->next) irq_vector_table[irq] = a->handler;
+    else irq_vector_table[irq] = irq_chain;
+}
 
 void irq_init(void) {
-    for (int i = 0; i < IRQ_COUNT; i++) irq_handlers[i] = (irq_handler_t)0;
+    for (int i = 0; i < IRQ_COUNT; i++) {
+        g_actions[i] = 0;
+        g_primary[i].handler = 0;
+        g_primary[i].next = 0;
+        irq_vector_table[i] = irq_none;
+    }
+    irq_vector_table[IRQ_BENCH] = irq_none;
 }
 
 void irq_install_handler(uint8_t irq, irq_handler_t handler) {
-    if (irq < IRQ_COUNT) irq_handlers[irq] = handler;
+    if (irq >= IRQ_COUNT || !handler) return;
+    uint32_t flags = irq_save();
+    g_primary[irq].handler = handler;
+    g_primary[irq].next = 0;
+    g_actions[irq] = &g_primary[irq];
+    update_vector(irq);
+    irq_restore(flags);
 }
 
 void irq_uninstall_handler(uint8_t irq) {
-    if (irq < IRQ_COUNT) irq_handlers[irq] = (irq_handler_t)0;
+    if (irq >= IRQ_COUNT) return;
+    uint32_t flags = irq_save();
+    g_actions[irq] = 0;
+    update_vector(irq);
+    irq_restore(flags);
+}
+
+void irq_add_handler(uint8_t irq, irq_action_t* action) {
+    if (irq >= IRQ_COUNT || !action || !action->handler) return;
+    uint32_t flags = irq_save();
+    action->next = 0;
+    irq_action_t** pp = &g_actions[irq];
+    while (*pp) pp = &(*pp)->next;
+    *pp = action;
+    update_vector(irq);
+    irq_restore(flags);
+}
+
+void irq_remove_handler(uint8_t irq, irq_action_t* action) {
+    if (irq >= IRQ_COUNT || !action) return;
+    uint32_t flags = irq_save();
+    for (irq_action_t** pp = &g_actions[irq]; *pp; pp = &(*pp)->next) {
+        if (*pp == action) {
+            *pp = action->next;
+            break;
+        }
+    }
+    update_vector(irq);
+    irq_restore(flags);
+}
+
+// Com o I/O APIC ativo o 8259 fica mascarado: mascara/EOI vao para o APIC
+void irq_mask(uint8_t irq) {
+    if (apic_active()) apic_irq_mask(irq);
+    else pic_mask_irq(irq);
+}
+
+void irq_unmask(uint8_t irq) {
+    if (apic_active()) apic_irq_unmask(irq);
+    else pic_unmask_irq(irq);
+}
+
+// EOI + trabalho adiado, comum aos dois caminhos
+static void irq_finish(uint8_t irq) {
+    // Sempre manda EOI, senao o PIC pode travar as proximas IRQs
+    if (apic_active()) apic_eoi();
+    else pic_send_eoi(irq);
+
+    // Contexto adiado: timers vencidos e o que os handlers marcaram rodam
+    // depois do EOI, com IRQs ligadas (softirq nao reentra).
+    if (timer_due(time_get_ticks())) softirq_raise(SOFTIRQ_TIMER);
+    softirq_irq_exit();
+
+    // Ponto de preempcao: a troca leva o quadro da IRQ junto na pilha do
+    // thread, que so faz o iret quando voltar a rodar.
+    sched_irq_exit();
+}
+
+void irq_exit(regs_t *r) {
+    uint8_t irq = (uint8_t)(r->int_no - PIC1_OFFSET);
+    if (irq >= IRQ_COUNT) return;       // irqbench
+
+    // Sem timestamp separado no caminho rapido: stub + handler juntos. O
+    // handler rodou com IF=0, entao irq_entry_tsc ainda e o deste IRQ.
+    irqstat_record(irq, 0, irq_entry_tsc, irqstat_now());
+    irq_finish(irq);
 }
 
 void irq_dispatch(regs_t *r) {
-    // IRQs foram remapeadas para 0x20-0x2F
+    // Copia antes de tudo: um IRQ aninhado sobrescreve o global
+    uint64_t entry = irq_entry_tsc;
+
+    // IRQs foram remapeadas para 0x20-0x2F (0x30 = irqbench)
     uint32_t int_no = r->int_no;
-    if (int_no < PIC1_OFFSET || int_no > (PIC1_OFFSET + 15)) {
+    if (int_no < PIC1_OFFSET || int_no > (PIC1_OFFSET + IRQ_BENCH)) {
         return;
     }
 
     uint8_t irq = (uint8_t)(int_no - PIC1_OFFSET);
 
-    // Chama handler se existir
-    if (irq < IRQ_COUNT && irq_handlers[irq]) {
-        irq_handlers[irq](r);
-    }
+    // Medido: entrada do stub e duracao do handler
+    uint64_t t0 = irqstat_now();
+    irq_vector_table[irq](r);
+    if (irq == IRQ_BENCH) return;
 
-    // Sempre manda EOI, senao o PIC pode travar as proximas IRQs
-    pic_send_eoi(irq);
+    irqstat_record(irq, entry, t0, irqstat_now());
+    irq_finish(irq);
 }
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: irqstat.c
+ * Descricao: Estatisticas de IRQ (contadores, histogramas, secoes com IRQs desligadas)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "irqstat.h"
+#include "irqflags.h"
+#include "clock.h"
+
+volatile uint64_t irq_entry_tsc = 0;
+uint8_t irqstat_tsc = 0;
+volatile uint32_t irqstat_spurious = 0;
+
+static irqstat_hist_t g_handler[IRQSTAT_LINES];
+static irqstat_hist_t g_entry[IRQSTAT_LINES];
+static irqoff_site_t g_off[IRQOFF_SITES];
+static int g_off_count = 0;
+
+void irqstat_init(void) {
+    irqstat_reset();
+    irqstat_tsc = clock_tsc_hz() ? 1 : 0;
+}
+
+static void hist_add(irqstat_hist_t* h, uint64_t cycles) {
+    uint32_t c = (cycles > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)cycles;
+    int b = 0;
+    if (c >= 128u) {
+        b = 31 - __builtin_clz(c) - 6;
+        if (b >= IRQSTAT_BUCKETS) b = IRQSTAT_BUCKETS - 1;
+    }
+    h->count++;
+    h->total += c;
+    if (c > h->max) h->max = c;
+    h->hist[b]++;
+}
+
+void irqstat_record(uint8_t irq, uint64_t entry, uint64_t start, uint64_t end) {
+    if (irq >= IRQSTAT_LINES) return;
+    if (!irqstat_tsc) {
+        g_handler[irq].count++;
+        return;
+    }
+    hist_add(&g_handler[irq], end - start);
+    // Sem timestamp do stub (0) ou de outra entrada (aninhada): ignora
+    if (entry && entry <= start) hist_add(&g_entry[irq], start - entry);
+}
+
+uint32_t irqstat_count(uint8_t irq) {
+    return (irq < IRQSTAT_LINES) ? g_handler[irq].count : 0;
+}
+
+const irqstat_hist_t* irqstat_handler(uint8_t irq) {
+    return (irq < IRQSTAT_LINES) ? &g_handler[irq] : 0;
+}
+
+const irqstat_hist_t* irqstat_entry(uint8_t irq) {
+    return (irq < IRQSTAT_LINES) ? &g_entry[irq] : 0;
+}
+
+void irqstat_reset(void) {
+    uint32_t flags = irq_save();
+    uint8_t* p = (uint8_t*)g_handler;
+    for (uint32_t i = 0; i < sizeof(g_handler); i++) p[i] = 0;
+    p = (uint8_t*)g_entry;
+    for (uint32_t i = 0; i < sizeof(g_entry); i++) p[i] = 0;
+    g_off_count = 0;
+    irqstat_spurious = 0;
+    irq_restore(flags);
+}
+
+// ---------------------------------------------------------------------------
+// Secoes com IRQs desligadas
+// ---------------------------------------------------------------------------
+
+void irqoff_end(const char* site, uint64_t t0) {
+    if (!irqstat_tsc || !t0) return;
+    uint64_t dt = irqstat_now() - t0;
+    uint32_t c = (dt > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)dt;
+
+    // Chamado ainda com IRQs desligadas: a tabela nao precisa de trava.
+    // Local identificado pelo ponteiro da string (literal unica por local).
+    irqoff_site_t* s = 0;
+    for (int i = 0; i < g_off_count; i++) {
+        if (g_off[i].site == site) { s = &g_off[i]; break; }
+    }
+    if (!s) {
+        if (g_off_count >= IRQOFF_SITES) return;
+        s = &g_off[g_off_count++];
+        s->site = site;
+        s->count = 0;
+        s->max = 0;
+        s->total = 0;
+    }
+    s->count++;
+    s->total += c;
+    if (c > s->max) s->max = c;
+}
+
+int irqoff_sites(irqoff_site_t* out, int max) {
+    uint32_t flags = irq_save();
+    int n = (g_off_count < max) ? g_off_count : max;
+    int used[IRQOFF_SITES] = {0};
+
+    // Selecao simples (poucos locais)
+    for (int k = 0; k < n; k++) {
+        int best = -1;
+        for (int i = 0; i < g_off_count; i++) {
+            if (used[i]) continue;
+            if (best < 0 || g_off[i].max > g_off[best].max) best = i;
+        }
+        used[best] = 1;
+        out[k] = g_off[best];
+    }
+    irq_restore(flags);
+    return n;
+}
@@ -16,6 +16,7 @@
 
 #include "isr.h"
 #include "console.h"
+#include "fpu.h"
 
 static const char *exc_names[32] = {
     "Divide-by-zero", "Debug", "NMI", "Breakpoint",
@@ -33,6 +34,11 @@ void isr_install(void) {
 }
 
 void isr_handler(regs_t *r) {
+    // #NM com CR0.TS: troca preguicosa do estado da FPU, nao e erro
+    if (r->int_no == 7 && fpu_handle_nm()) return;
+
+    // Vai travar: o console nao pode ficar esperando o idle para aparecer
+    console_defer_present(0);
     vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_RED);
     vga_write("\n\n!!! EXCEPTION !!!\n");
     vga_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
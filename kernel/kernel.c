@@ -17,9 +17,16 @@
 #include <stdint.h>
 #include "idt.h"
 #include "pic.h"
+#include "apic.h"
 #include "irq.h"
+#include "softirq.h"
+#include "irqstat.h"
+#include "cpu.h"
+#include "fpu.h"
+#include "idle.h"
+#include "sched.h"
+#include "smp.h"
 #include "io.h"
-#include "cmos.h"
 #include "time.h"
 #include "delay.h"
 #include "memory.h"
@@ -33,6 +40,10 @@
 #include "programs/shice.h"
 #include "splash.h"
 #include "math.h"
+#include "event.h"
+#include "bootmod.h"
+#include "gfx.h"
+#include "tick.h"
 
 #define MULTIBOOT_MAGIC 0x2BADB002u
 
@@ -89,7 +100,7 @@ static volatile uint32_t g_ticks = 0;
 static void timer_irq(regs_t *r) {
     (void)r;
     time_tick();
-    delay_tick();
+    tick_irq_exit();            // tickless: arma o proximo one-shot
 }
 
 static void keyboard_irq(regs_t *r) {
@@ -105,12 +116,16 @@ static void keyboard_irq(regs_t *r) {
 }
 
 void kernel_main(uint32_t magic, uint32_t mb_info) {
+    // 0) CPUID + FPU/SSE ligados: os drivers escolhem suas variantes no init
+    cpu_init();
+    fpu_init();
+
     // 1) VGA primeiro: se qualquer coisa travar, voce ainda ve o log
     video_init_system((void*)mb_info);
 	
 	console_init();
 	
-	vga_write("VBE/GOB Video Driver");
+	vga_write(g_video_driver ? "VBE/GOB Video Driver" : "VGA Text Console (80x25)");
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n\n");
 	
@@ -164,12 +179,14 @@ void kernel_main(uint32_t magic, uint32_t mb_info) {
     vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
 	vga_write("[1] Memory... ");
 	memory_init(magic, mb_info);
+	bootmod_init(magic, mb_info);   // modulos do GRUB (ja reservados pelo memory_init)
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n");
 
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
 	vga_write("[2] SysConfig... ");
 	sysconfig_init();
+	gfx_init();                     // escolhe escalar/SSE2 para as primitivas 2D
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n");
 
@@ -182,57 +199,68 @@ void kernel_main(uint32_t magic, uint32_t mb_info) {
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
     vga_write("[4] PIC... ");
     pic_init();
+    // LAPIC + I/O APIC quando a MADT existe; senao segue no 8259
+    vga_write(apic_init() ? "APIC" : "8259");
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
     vga_write("[5] IRQ layer... ");
     irq_init();
+    softirq_init();
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-	vga_write("[6] CMOS... ");
-	rtc_time_t t;
-	cmos_read_rtc(&t);
-	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
-	vga_write(" [OK]\n");
-	
-	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-	vga_write("[7] TIME... ");
+	vga_write("[6] TIME... ");
 	time_init(1000);
 	delay_init(1000);
+	irqstat_init();                 // TSC pronto: liga as medidas de IRQ
+	idle_init();                    // MWAIT/HLT + contabilidade de ocioso
+	sched_init();                   // este fluxo vira o thread "main"
+	// Hora de parede que time_init() leu do RTC
+	vga_write(time_datetime_str());
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-	vga_write("[8] Basic Handlers... ");
+	vga_write("[7] Basic Handlers... ");
     irq_install_handler(0, timer_irq);     // IRQ0 = PIT
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-	vga_write("[9] IRQ Unmasking... ");
-    pic_unmask_irq(0);
+	vga_write("[8] IRQ Unmasking... ");
+    irq_unmask(0);
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
 	vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-    vga_write("[10] STI (enable interrupts)... ");
+    vga_write("[9] STI (enable interrupts)... ");
     __asm__ volatile("sti");
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-    vga_write("[11] Keyboard... ");
+    vga_write("[10] Keyboard... ");
     keyboard_init();
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_write(" [OK]\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
-    vga_write("[12] Mouse... ");
+    vga_write("[11] Mouse... ");
     mouse_init();
 	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
+    vga_write(" [OK]\n");
+	
+	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+    vga_write("[12] SMP... ");
+    // APs via INIT-SIPI-SIPI; o kernel segue no BSP, os APs atendem smp_call
+    int ncpu = smp_init();
+    if (ncpu >= 10) vga_putc((char)('0' + ncpu / 10));
+    vga_putc((char)('0' + ncpu % 10));
+    vga_write(" CPU(s)");
+	vga_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_write(" [OK]\n\n");
 	
 	vga_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
@@ -252,8 +280,9 @@ void kernel_main(uint32_t magic, uint32_t mb_info) {
 	delay_time(2);
     splash_show(3);
 	console_clear();
+    console_defer_present(1);       // shell: present do console no idle
     shice_run();
 
     // shice_run() não retorna, mas por segurança:
-    for(;;) { __asm__ volatile("hlt"); }
+    for(;;) { __asm__ volatile("cli"); cpu_idle(); }
 }
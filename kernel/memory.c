@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include "memory.h"
+#include "irqflags.h"
 
 #define MULTIBOOT_MAGIC 0x2BADB002u
 
@@ -52,6 +53,30 @@ static inline uint32_t align_up_u32(uint32_t v, uint32_t a) {
     return (v + (a - 1u)) & ~(a - 1u);
 }
 
+// Fim do kernel + modulos multiboot. O GRUB costuma carregar os modulos logo
+// depois do kernel: bitmap e heap precisam comecar depois deles, senao o
+// primeiro kmalloc grande sobrescreve o modulo.
+static uint32_t image_end(const multiboot_info_t *mb) {
+    uint32_t end = (uint32_t)&_kernel_end;
+    if ((mb->flags & (1u << 3)) == 0u || mb->mods_count == 0u) return end;
+
+    // multiboot_mod_list: mod_start, mod_end, cmdline, pad
+    const uint32_t *mods = (const uint32_t*)mb->mods_addr;
+    uint32_t list_end = mb->mods_addr + mb->mods_count * 16u;
+    if (list_end > end) end = list_end;
+
+    for (uint32_t i = 0; i < mb->mods_count; i++) {
+        if (mods[i * 4u + 1u] > end) end = mods[i * 4u + 1u];
+        const char *cmd = (const char*)mods[i * 4u + 2u];
+        if (cmd) {
+            uint32_t n = 0;
+            while (cmd[n] && n < 4096u) n++;
+            if ((uint32_t)cmd + n + 1u > end) end = (uint32_t)cmd + n + 1u;
+        }
+    }
+    return end;
+}
+
 // ----------------------------
 // PMM (bitmap de frames 4KiB)
 // ----------------------------
@@ -107,23 +132,28 @@ static void pmm_mark_region_used(uint32_t base, uint32_t length) {
 }
 
 uint32_t pmm_alloc_page(void) {
+    uint32_t flags = irq_save();
     for (uint32_t f = 0; f < g_pmm_frames_total; f++) {
         if (!bitmap_test(f)) {
             bitmap_set(f);
             g_pmm_frames_used++;
+            irq_restore(flags);
             return f * PAGE_SIZE;
         }
     }
+    irq_restore(flags);
     return 0;
 }
 
 void pmm_free_page(uint32_t paddr) {
     uint32_t f = paddr / PAGE_SIZE;
     if (f >= g_pmm_frames_total) return;
+    uint32_t flags = irq_save();
     if (bitmap_test(f)) {
         bitmap_clear(f);
         g_pmm_frames_used--;
     }
+    irq_restore(flags);
 }
 
 // ----------------------------
@@ -250,7 +280,9 @@ static int heap_grow(uint32_t more_bytes) {
     return 1;
 }
 
-void* kmalloc(uint32_t size) {
+// Com threads preemptivos o heap e compartilhado: kmalloc/kfree rodam
+// inteiros com IRQs desligadas (nenhuma troca no meio da lista).
+static void* heap_alloc(uint32_t size) {
     if (size == 0) return 0;
     uint32_t needed = ALIGN8(size);
 
@@ -266,6 +298,13 @@ void* kmalloc(uint32_t size) {
     return (void*)((uint8_t*)blk + (uint32_t)sizeof(heap_block_t));
 }
 
+void* kmalloc(uint32_t size) {
+    uint32_t flags = irq_save();
+    void* p = heap_alloc(size);
+    irq_restore(flags);
+    return p;
+}
+
 void* kmalloc_aligned(uint32_t size, uint32_t align) {
     if (align < 8u) align = 8u;
     // align deve ser potencia de 2
@@ -297,8 +336,10 @@ void kfree(void *ptr) {
     heap_block_t *blk = (heap_block_t*)((uint8_t*)ptr - (uint32_t)sizeof(heap_block_t));
     if (blk->magic != HEAP_MAGIC) return;
 
+    uint32_t flags = irq_save();
     blk->free = 1;
     heap_coalesce(blk);
+    irq_restore(flags);
 }
 
 // ----------------------------
@@ -373,7 +414,7 @@ void memory_init(uint32_t multiboot_magic, uint32_t mb_info_ptr) {
     multiboot_info_t *mb = (multiboot_info_t*)mb_info_ptr;
 
     if ((mb->flags & (1u << 6)) == 0u) {
-        uint32_t kend = (uint32_t)&_kernel_end;
+        uint32_t kend = image_end(mb);
         uint32_t heap_base = align_up_u32(kend, 16u);
         heap_init(heap_base, KERNEL_HEAP_SIZE);
         return;
@@ -392,7 +433,7 @@ void memory_init(uint32_t multiboot_magic, uint32_t mb_info_ptr) {
 
     g_pmm_bitmap_bytes = (g_pmm_frames_total + 7u) / 8u;
 
-    uint32_t kend = (uint32_t)&_kernel_end;
+    uint32_t kend = image_end(mb);
     uint32_t bitmap_addr = align_up_u32(kend, 16u);
     g_pmm_bitmap = (uint8_t*)bitmap_addr;
 
@@ -429,7 +470,7 @@ void memory_init(uint32_t multiboot_magic, uint32_t mb_info_ptr) {
     // Protege região baixa
     pmm_mark_region_used(0u, 0x100000u);
 
-    // Protege Kernel + Bitmap + HEAP GRANDE
+    // Protege Kernel + Modulos + Bitmap + HEAP GRANDE
     uint32_t reserved_end = heap_base + KERNEL_HEAP_SIZE;
     
     // Garante que não passamos do fim da RAM física
@@ -0,0 +1,65 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: pit.c
+ * Descricao: Programacao do PIT 8253/8254 (canal 0 = IRQ0, canal 2 = calibracao).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "pit.h"
+#include "io.h"
+#include "math.h"
+
+#define PIT_CH0     0x40
+#define PIT_CH2     0x42
+#define PIT_CMD     0x43
+#define PORT_B      0x61    // bit0 = gate do canal 2, bit1 = alto-falante, bit5 = OUT2
+
+void pit_set_periodic(uint32_t hz) {
+    if (hz == 0) hz = 1000;
+    uint32_t divisor = PIT_HZ / hz;
+    if (divisor == 0) divisor = 1;
+    if (divisor > 0xFFFF) divisor = 0xFFFF;
+
+    outb(PIT_CMD, 0x36);                        // canal 0, lo/hi, modo 3, binario
+    outb(PIT_CH0, (uint8_t)(divisor & 0xFF));
+    outb(PIT_CH0, (uint8_t)(divisor >> 8));
+}
+
+void pit_set_oneshot(uint32_t delta_ns) {
+    // pulsos = ns * PIT_HZ / 1e9  (PIT_HZ/1e9 * 2^41 = 2623834966.1)
+    uint32_t count = (uint32_t)mul_u64_u32_shr(delta_ns, 2623834966u, 41);
+    if (count == 0) count = 1;
+    if (count > 0xFFFF) count = 0xFFFF;
+
+    outb(PIT_CMD, 0x30);                        // canal 0, lo/hi, modo 0, binario
+    outb(PIT_CH0, (uint8_t)(count & 0xFF));
+    outb(PIT_CH0, (uint8_t)(count >> 8));       // arma aqui
+}
+
+void pit_stop(void) {
+    // No modo 0 o contador so comeca quando a contagem e escrita
+    outb(PIT_CMD, 0x30);
+}
+
+void pit_ch2_start(uint16_t count) {
+    // Gate ligado, alto-falante desligado
+    outb(PORT_B, (uint8_t)((inb(PORT_B) & ~0x02) | 0x01));
+
+    outb(PIT_CMD, 0xB0);                        // canal 2, lo/hi, modo 0, binario
+    outb(PIT_CH2, (uint8_t)(count & 0xFF));
+    outb(PIT_CH2, (uint8_t)(count >> 8));       // a contagem comeca aqui
+}
+
+int pit_ch2_expired(void) {
+    return (inb(PORT_B) & 0x20) ? 1 : 0;
+}
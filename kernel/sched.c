@@ -0,0 +1,425 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: sched.c
+ * Descricao: Threads do kernel: escalonador round-robin preemptivo com prioridades.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "sched.h"
+#include "irqflags.h"
+#include "memory.h"
+#include "clock.h"
+#include "time.h"
+#include "timer.h"
+#include "softirq.h"
+#include "idle.h"
+#include "fpu.h"
+#include "delay.h"
+#include "math.h"
+
+// Troca de pilha: salva os registradores preservados pelo cdecl na pilha
+// atual, guarda o esp em *save e retoma a pilha 'next' no mesmo formato.
+// Sempre chamada com IF=0; o EFLAGS volta pelo irq_restore/iret de quem
+// estava do outro lado.
+__asm__(
+    ".text\n"
+    ".globl sched_switch\n"
+    "sched_switch:\n"
+    "    pushl %ebp\n"
+    "    pushl %ebx\n"
+    "    pushl %esi\n"
+    "    pushl %edi\n"
+    "    movl 20(%esp), %eax\n"
+    "    movl %esp, (%eax)\n"
+    "    movl 24(%esp), %esp\n"
+    "    popl %edi\n"
+    "    popl %esi\n"
+    "    popl %ebx\n"
+    "    popl %ebp\n"
+    "    ret\n"
+);
+
+typedef struct {
+    thread_t* head;
+    thread_t* tail;
+} run_queue_t;
+
+static thread_t g_main_thread;
+static thread_t* g_current = &g_main_thread;
+static thread_t* g_idle = 0;
+static thread_t* g_all = 0;
+static thread_t* g_zombies = 0;
+static run_queue_t g_rq[SCHED_PRIO_COUNT];
+static uint32_t g_next_id = 0;
+
+static volatile int g_active = 0;
+static volatile int g_need_resched = 0;
+static volatile int g_preempt_count = 0;
+static uint64_t g_run_start = 0;            // inicio da vez do atual (runtime)
+
+// Fatia: um timer one-shot so existe enquanto ha disputa na mesma prioridade
+static ktimer_t* g_slice = 0;
+
+// Threads em cpu_idle(): qualquer IRQ os acorda (mesma semantica do HLT)
+static wait_queue_t g_irq_wq = WAIT_QUEUE_INIT;
+
+static thread_t* thread_alloc(const char* name, void (*fn)(void* arg), void* arg, int prio);
+
+static void copy_name(char* dst, const char* src) {
+    int i = 0;
+    if (src) {
+        for (; src[i] && i < SCHED_NAME_MAX - 1; i++) dst[i] = src[i];
+    }
+    dst[i] = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Filas (sempre com IF=0)
+// ---------------------------------------------------------------------------
+
+static void rq_push(thread_t* t) {
+    run_queue_t* q = &g_rq[t->prio];
+    t->next = 0;
+    if (q->tail) q->tail->next = t;
+    else q->head = t;
+    q->tail = t;
+}
+
+static thread_t* rq_pop(void) {
+    for (int p = 0; p < SCHED_PRIO_COUNT; p++) {
+        run_queue_t* q = &g_rq[p];
+        thread_t* t = q->head;
+        if (!t) continue;
+        q->head = t->next;
+        if (!q->head) q->tail = 0;
+        t->next = 0;
+        return t;
+    }
+    return 0;
+}
+
+// Ha alguem pronto com prioridade igual ou maior que 'prio'?
+static int rq_ready_upto(int prio) {
+    for (int p = 0; p <= prio && p < SCHED_PRIO_COUNT; p++) {
+        if (g_rq[p].head) return 1;
+    }
+    return 0;
+}
+
+static void slice_expired(void* arg) {
+    (void)arg;
+    uint32_t flags = irq_save();
+    g_slice = 0;
+    if (rq_ready_upto(g_current->prio)) g_need_resched = 1;
+    irq_restore(flags);
+}
+
+static void arm_slice(void) {
+    if (g_slice) return;
+    g_slice = timer_add(time_get_ticks() + SCHED_SLICE_MS, slice_expired, 0);
+}
+
+static void make_ready(thread_t* t) {
+    t->state = THREAD_READY;
+    rq_push(t);
+    if (t->prio < g_current->prio) g_need_resched = 1;
+    else if (t->prio == g_current->prio) arm_slice();
+}
+
+// ---------------------------------------------------------------------------
+// Troca
+// ---------------------------------------------------------------------------
+
+// Escolhe o proximo e troca. Com IF=0; volta quando 'prev' for escolhido de
+// novo (ou nunca, se ele morreu).
+static void schedule(void) {
+    g_need_resched = 0;
+    thread_t* prev = g_current;
+    if (prev->state == THREAD_RUNNING && prev != g_idle) {
+        prev->state = THREAD_READY;
+        rq_push(prev);
+    }
+
+    thread_t* next = rq_pop();
+    if (!next) next = g_idle;
+    if (next == prev) {
+        prev->state = THREAD_RUNNING;
+        return;
+    }
+    if (prev == g_idle) prev->state = THREAD_READY;     // fora da fila, mas pronto
+
+    uint64_t now = clock_ns();
+    prev->runtime_ns += now - g_run_start;
+    g_run_start = now;
+    if (prev == g_idle) idle_leave();       // fecha o intervalo ocioso agora
+
+    next->state = THREAD_RUNNING;
+    next->switches++;
+    g_current = next;
+    if (g_rq[next->prio].head) arm_slice();
+    fpu_switch(&next->fpu);
+    sched_switch(&prev->esp, next->esp);
+}
+
+// Primeira instrucao de todo thread novo (vem do 'ret' do sched_switch)
+static void thread_start(void) {
+    __asm__ volatile("sti");
+    g_current->fn(g_current->arg);
+    sched_exit();
+}
+
+// Libera pilha e estrutura de quem ja terminou (roda no thread ocioso)
+static void reap(void) {
+    for (;;) {
+        uint32_t flags = irq_save();
+        thread_t* z = g_zombies;
+        if (z) {
+            g_zombies = z->next;
+            for (thread_t** pp = &g_all; *pp; pp = &(*pp)->all_next) {
+                if (*pp == z) { *pp = z->all_next; break; }
+            }
+        }
+        irq_restore(flags);
+        if (!z) return;
+        kfree(z->stack);
+        if (z->fibers) kfree(z->fibers);    // so o anel: fibers vivas ficam perdidas
+        kfree(z);
+    }
+}
+
+static void idle_thread(void* arg) {
+    (void)arg;
+    for (;;) {
+        reap();
+        __asm__ volatile("cli");
+        if (g_need_resched || rq_ready_upto(SCHED_PRIO_LOW)) {
+            schedule();
+            __asm__ volatile("sti");
+            continue;
+        }
+        cpu_idle();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void sched_init(void) {
+    for (int p = 0; p < SCHED_PRIO_COUNT; p++) {
+        g_rq[p].head = 0;
+        g_rq[p].tail = 0;
+    }
+
+    thread_t* m = &g_main_thread;
+    m->id = g_next_id++;
+    copy_name(m->name, "main");
+    m->prio = SCHED_PRIO_NORMAL;
+    m->state = THREAD_RUNNING;
+    m->stack = 0;
+    m->runtime_ns = 0;
+    m->switches = 1;
+    m->all_next = 0;
+    fpu_state_init(&m->fpu);
+    fpu_switch(&m->fpu);
+    g_all = m;
+    g_current = m;
+    g_run_start = clock_ns();
+
+    // O ocioso nao entra na fila: e o que roda quando ela esta vazia
+    g_idle = thread_alloc("idle", idle_thread, 0, SCHED_PRIO_IDLE);
+    if (!g_idle) return;
+    uint32_t flags = irq_save();
+    g_idle->state = THREAD_READY;
+    g_active = 1;
+    irq_restore(flags);
+}
+
+int sched_active(void) {
+    return g_active;
+}
+
+static thread_t* thread_alloc(const char* name, void (*fn)(void* arg), void* arg, int prio) {
+    thread_t* t = (thread_t*)kmalloc_aligned((uint32_t)sizeof(thread_t), 16);
+    if (!t) return 0;
+    // Topo alinhado em 16: o thread comeca com a pilha como o ABI espera
+    uint8_t* stack = (uint8_t*)kmalloc_aligned(SCHED_STACK_SIZE, 16);
+    if (!stack) { kfree(t); return 0; }
+
+    copy_name(t->name, name);
+    t->prio = (uint8_t)prio;
+    t->fn = fn;
+    t->arg = arg;
+    t->stack = stack;
+    t->runtime_ns = 0;
+    t->switches = 0;
+    t->fibers = 0;
+    fpu_state_init(&t->fpu);
+
+    // Pilha inicial no formato do sched_switch: edi, esi, ebx, ebp, retorno
+    uint32_t* sp = (uint32_t*)(stack + SCHED_STACK_SIZE);
+    *--sp = 0;                                  // retorno falso de thread_start
+    *--sp = (uint32_t)(uintptr_t)thread_start;
+    *--sp = 0;                                  // ebp
+    *--sp = 0;                                  // ebx
+    *--sp = 0;                                  // esi
+    *--sp = 0;                                  // edi
+    t->esp = sp;
+
+    uint32_t flags = irq_save();
+    t->id = g_next_id++;
+    t->all_next = g_all;
+    g_all = t;
+    irq_restore(flags);
+    return t;
+}
+
+thread_t* thread_create(const char* name, void (*fn)(void* arg), void* arg, int prio) {
+    if (!fn || !g_active) return 0;
+    if (prio < 0 || prio >= SCHED_PRIO_IDLE) prio = SCHED_PRIO_NORMAL;
+    thread_t* t = thread_alloc(name, fn, arg, prio);
+    if (!t) return 0;
+    uint32_t flags = irq_save();
+    make_ready(t);
+    irq_restore(flags);
+    return t;
+}
+
+thread_t* sched_current(void) {
+    return g_current;
+}
+
+void sched_yield(void) {
+    if (!g_active) return;
+    uint32_t flags = irq_save();
+    schedule();
+    irq_restore(flags);
+}
+
+void sched_exit(void) {
+    __asm__ volatile("cli");
+    thread_t* t = g_current;
+    t->state = THREAD_DEAD;
+    t->next = g_zombies;
+    g_zombies = t;
+    schedule();
+    for (;;) __asm__ volatile("hlt");   // nao volta: ninguem escolhe um morto
+}
+
+static void sleep_timeout(void* arg) {
+    thread_t* t = (thread_t*)arg;
+    uint32_t flags = irq_save();
+    if (t->state == THREAD_BLOCKED) make_ready(t);
+    irq_restore(flags);
+}
+
+void sched_sleep_ms(uint32_t ms) {
+    if (g_active && g_current != g_idle) {
+        __asm__ volatile("cli");
+        thread_t* t = g_current;
+        if (timer_add(time_get_ticks() + ms, sleep_timeout, t)) {
+            t->state = THREAD_BLOCKED;
+            schedule();
+            __asm__ volatile("sti");
+            return;
+        }
+        __asm__ volatile("sti");
+    }
+    delay_ms(ms);       // sem escalonador ou pool de timers cheio
+}
+
+void sched_sleep_on(wait_queue_t* wq) {
+    thread_t* t = g_current;
+    if (!g_active || t == g_idle) {
+        __asm__ volatile("sti");
+        return;
+    }
+    t->state = THREAD_BLOCKED;
+    t->next = 0;
+    if (wq->tail) wq->tail->next = t;
+    else wq->head = t;
+    wq->tail = t;
+    schedule();
+    __asm__ volatile("sti");
+}
+
+void wake_up(wait_queue_t* wq) {
+    uint32_t flags = irq_save();
+    thread_t* t = wq->head;
+    if (t) {
+        wq->head = t->next;
+        if (!wq->head) wq->tail = 0;
+        make_ready(t);
+    }
+    irq_restore(flags);
+}
+
+void wake_up_all(wait_queue_t* wq) {
+    uint32_t flags = irq_save();
+    thread_t* t = wq->head;
+    wq->head = 0;
+    wq->tail = 0;
+    while (t) {
+        thread_t* n = t->next;
+        make_ready(t);
+        t = n;
+    }
+    irq_restore(flags);
+}
+
+void preempt_disable(void) {
+    g_preempt_count++;
+    __asm__ volatile("" ::: "memory");
+}
+
+void preempt_enable(void) {
+    __asm__ volatile("" ::: "memory");
+    if (--g_preempt_count || !g_need_resched || !g_active) return;
+    // So troca daqui se o chamador estava com IRQs ligadas (contexto de thread)
+    uint32_t flags = irq_save();
+    if ((flags & 0x200u) && !softirq_active() && !kernel_fpu_active()) schedule();
+    irq_restore(flags);
+}
+
+int sched_wait_irq(void) {
+    if (!g_active || g_current == g_idle) return 0;
+    sched_sleep_on(&g_irq_wq);
+    return 1;
+}
+
+void sched_irq_exit(void) {
+    if (!g_active) return;
+    if (g_irq_wq.head) wake_up_all(&g_irq_wq);
+    // IRQ aninhada (dentro de softirq), trecho sem preempcao ou com os XMM
+    // em uso pelo kernel: fica para a proxima
+    if (!g_need_resched || g_preempt_count || softirq_active() || kernel_fpu_active()) return;
+    schedule();
+}
+
+int sched_snapshot(sched_info_t* out, int max) {
+    int n = 0;
+    uint64_t now = clock_ns();
+    uint32_t flags = irq_save();
+    for (thread_t* t = g_all; t && n < max; t = t->all_next, n++) {
+        sched_info_t* o = &out[n];
+        o->id = t->id;
+        copy_name(o->name, t->name);
+        o->prio = t->prio;
+        o->state = t->state;
+        uint64_t ns = t->runtime_ns + (t == g_current ? now - g_run_start : 0);
+        o->runtime_ms = (uint32_t)mul_u64_u32_shr(ns, 1125899907u, 50);   // ns / 1e6
+        o->switches = t->switches;
+    }
+    irq_restore(flags);
+    return n;
+}
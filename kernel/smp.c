@@ -0,0 +1,296 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: smp.c
+ * Descricao: SMP: partida dos APs (INIT-SIPI-SIPI), dados por CPU e chamadas por IPI.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "smp.h"
+#include "irqflags.h"
+#include "apic.h"
+#include "tss.h"
+#include "idt.h"
+#include "cpu.h"
+#include "clock.h"
+#include "delay.h"
+#include "idle.h"
+#include "memory.h"
+#include "math.h"
+
+// Codigo de partida dos APs (boot/ap_trampoline.s): copiado para
+// SMP_TRAMPOLINE; a pilha e a entrada ficam no fim e sao preenchidas aqui.
+extern char ap_trampoline_start[];
+extern char ap_trampoline_end[];
+extern char ap_trampoline_stack[];
+extern char ap_trampoline_entry[];
+
+#define CR0_TS       (1u << 3)
+#define BOOT_WAIT_MS 100
+
+typedef struct {
+    uint32_t index;
+    uint8_t  apic_id;
+    volatile uint8_t online;
+    void* stack;
+
+    // Caixa de correio: uma chamada por vez. Quem chama publica fn/arg e
+    // depois incrementa req; o AP roda e copia req para done.
+    volatile uint32_t lock;
+    smp_fn_t volatile fn;
+    void* volatile arg;
+    volatile uint32_t req;
+    volatile uint32_t done;
+
+    volatile uint32_t calls;
+    volatile uint32_t wakeups;
+    uint64_t online_tsc;
+    volatile uint64_t idle_tsc;
+} cpu_t;
+
+static cpu_t g_cpus[SMP_MAX_CPUS];
+static int g_count = 1;
+static uint8_t g_apic_to_cpu[256];
+static cpu_t* volatile g_booting = 0;
+static uint32_t g_cr0 = 0, g_cr4 = 0;
+static int g_tsc = 0;
+
+static inline void spin_lock(volatile uint32_t* l) {
+    while (__atomic_exchange_n(l, 1u, __ATOMIC_ACQUIRE))
+        while (*l) __asm__ volatile("pause");
+}
+
+static inline void spin_unlock(volatile uint32_t* l) {
+    __atomic_store_n(l, 0u, __ATOMIC_RELEASE);
+}
+
+// TSC lido direto: o clocksource do kernel nao e seguro fora do BSP
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// ---------------------------------------------------------------------------
+// Lado do AP
+// ---------------------------------------------------------------------------
+
+// Loop ocioso de cada AP: roda o que estiver na caixa de correio, senao
+// dorme ate o proximo IPI (sti; hlt nao perde o IPI que chega no meio).
+static void ap_idle(cpu_t* c) __attribute__((noreturn));
+
+static void ap_idle(cpu_t* c) {
+    for (;;) {
+        __asm__ volatile("cli");
+        uint32_t req = c->req;
+        if (req != c->done) {
+            __asm__ volatile("sti");
+            smp_fn_t fn = c->fn;
+            void* arg = c->arg;
+            fn(arg);
+            c->calls++;
+            __atomic_store_n(&c->done, req, __ATOMIC_RELEASE);
+            continue;
+        }
+        uint64_t t0 = g_tsc ? rdtsc() : 0;
+        __asm__ volatile("sti; hlt" ::: "memory");
+        if (g_tsc) c->idle_tsc += rdtsc() - t0;
+        c->wakeups++;
+    }
+}
+
+// Chamado pelo trampolim, ja em modo protegido na pilha do AP
+static void ap_entry(void) __attribute__((noreturn));
+
+static void ap_entry(void) {
+    cpu_t* c = g_booting;
+    // Um AP atrasado (o BSP ja desistiu dele) so para
+    if (!c || c->apic_id != apic_id()) {
+        for (;;) __asm__ volatile("cli; hlt");
+    }
+
+    // Mesmo CR0/CR4 do BSP (cache ligado, SSE), sem o TS do FPU lazy
+    __asm__ volatile("mov %0, %%cr0" :: "r"(g_cr0) : "memory");
+    if (g_cr4) __asm__ volatile("mov %0, %%cr4" :: "r"(g_cr4) : "memory");
+    if (cpu_has(CPU_FPU)) __asm__ volatile("fninit");
+
+    tss_cpu_init((int)c->index, (uint32_t)(uintptr_t)c->stack + SMP_STACK_SIZE);
+    idt_load();
+    apic_ap_init();
+
+    c->online_tsc = g_tsc ? rdtsc() : 0;
+    __atomic_store_n(&c->online, 1, __ATOMIC_RELEASE);
+    ap_idle(c);
+}
+
+void smp_ipi_handler(void) {
+    apic_eoi();
+}
+
+// ---------------------------------------------------------------------------
+// Partida (BSP)
+// ---------------------------------------------------------------------------
+
+static void trampoline_install(void) {
+    uint8_t* dst = (uint8_t*)(uintptr_t)SMP_TRAMPOLINE;
+    uint32_t n = (uint32_t)(ap_trampoline_end - ap_trampoline_start);
+    for (uint32_t i = 0; i < n; i++) dst[i] = (uint8_t)ap_trampoline_start[i];
+}
+
+static void trampoline_set(char* field, uint32_t v) {
+    uint32_t off = (uint32_t)(field - ap_trampoline_start);
+    *(volatile uint32_t*)(uintptr_t)(SMP_TRAMPOLINE + off) = v;
+}
+
+// INIT, 10ms, SIPI (e um segundo SIPI se o primeiro nao pegou)
+static int start_ap(cpu_t* c) {
+    g_booting = c;
+    apic_send_ipi(c->apic_id, APIC_ICR_INIT | APIC_ICR_LEVEL | APIC_ICR_ASSERT);
+    delay_ms(10);
+    for (int k = 0; k < 2 && !c->online; k++) {
+        apic_send_ipi(c->apic_id, APIC_ICR_STARTUP | (SMP_TRAMPOLINE >> 12));
+        delay_us(200);
+    }
+    uint32_t t0 = clock_ms();
+    while (!c->online && clock_ms() - t0 < BOOT_WAIT_MS) delay_us(50);
+    g_booting = 0;
+    return c->online;
+}
+
+int smp_init(void) {
+    cpu_t* b = &g_cpus[0];
+    b->index = 0;
+    b->apic_id = apic_id();
+    b->online = 1;
+    g_apic_to_cpu[b->apic_id] = 0;
+    tss_cpu_init(0, 0);             // o BSP tambem ganha GDT/TSS proprios
+
+    if (!apic_active() || apic_cpu_count() < 2) return g_count;
+
+    uint32_t cr0;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    g_cr0 = cr0 & ~CR0_TS;
+    __asm__ volatile("mov %%cr4, %0" : "=r"(g_cr4));    // LAPIC integrado: ha CR4
+    g_tsc = cpu_has(CPU_TSC);
+
+    trampoline_install();
+    trampoline_set(ap_trampoline_entry, (uint32_t)(uintptr_t)ap_entry);
+
+    for (int i = 0; i < apic_cpu_count() && g_count < SMP_MAX_CPUS; i++) {
+        uint8_t id = apic_cpu_apic_id(i);
+        if (id == b->apic_id) continue;
+
+        cpu_t* c = &g_cpus[g_count];
+        if (!c->stack) c->stack = kmalloc_aligned(SMP_STACK_SIZE, 16);
+        if (!c->stack) break;
+        c->index = (uint32_t)g_count;
+        c->apic_id = id;
+        c->online = 0;
+        c->req = 0;
+        c->done = 0;
+        trampoline_set(ap_trampoline_stack, (uint32_t)(uintptr_t)c->stack + SMP_STACK_SIZE);
+
+        if (start_ap(c)) {
+            g_apic_to_cpu[id] = (uint8_t)g_count;
+            g_count++;
+        } else {
+            c->stack = 0;           // pode acordar tarde: a pilha fica com ele
+        }
+    }
+    return g_count;
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+int smp_cpu_count(void) {
+    return g_count;
+}
+
+int smp_cpu_id(void) {
+    if (g_count <= 1) return 0;
+    return g_apic_to_cpu[apic_id()];
+}
+
+// Publica uma chamada e devolve o numero dela (para esperar)
+static uint32_t post(cpu_t* c, smp_fn_t fn, void* arg) {
+    uint32_t flags;
+    for (;;) {
+        flags = irq_save();
+        spin_lock(&c->lock);
+        if (c->done == c->req) break;       // a anterior ja terminou
+        spin_unlock(&c->lock);
+        irq_restore(flags);
+        __asm__ volatile("pause");
+    }
+    c->fn = fn;
+    c->arg = arg;
+    uint32_t req = c->req + 1;
+    __atomic_store_n(&c->req, req, __ATOMIC_RELEASE);
+    spin_unlock(&c->lock);
+    irq_restore(flags);
+
+    apic_send_ipi(c->apic_id, APIC_ICR_FIXED | SMP_IPI_VECTOR);
+    return req;
+}
+
+static void wait_done(cpu_t* c, uint32_t req) {
+    while ((int32_t)(c->done - req) < 0) __asm__ volatile("pause");
+}
+
+int smp_call(int cpu, smp_fn_t fn, void* arg, int wait) {
+    if (cpu < 0 || cpu >= g_count || !fn) return -1;
+    if (cpu == smp_cpu_id()) {
+        fn(arg);
+        return 0;
+    }
+    cpu_t* c = &g_cpus[cpu];
+    uint32_t req = post(c, fn, arg);
+    if (wait) wait_done(c, req);
+    return 0;
+}
+
+void smp_call_all(smp_fn_t fn, void* arg) {
+    uint32_t req[SMP_MAX_CPUS];
+    int me = smp_cpu_id();
+    for (int i = 0; i < g_count; i++)
+        if (i != me) req[i] = post(&g_cpus[i], fn, arg);
+    fn(arg);
+    for (int i = 0; i < g_count; i++)
+        if (i != me) wait_done(&g_cpus[i], req[i]);
+}
+
+int smp_snapshot(smp_info_t* out, int max) {
+    int n = 0;
+    uint64_t now = g_tsc ? rdtsc() : 0;
+    for (int i = 0; i < g_count && n < max; i++, n++) {
+        cpu_t* c = &g_cpus[i];
+        smp_info_t* o = &out[n];
+        o->index = c->index;
+        o->apic_id = c->apic_id;
+        o->online = c->online;
+        o->calls = c->calls;
+        o->wakeups = c->wakeups;
+        o->idle_pm = 0;
+        if (i == 0) {
+            idle_stats_t st;
+            idle_stats(&st);
+            if (st.total_ns) o->idle_pm = (uint32_t)udiv64(st.idle_ns * 1000u, st.total_ns, 0);
+        } else if (g_tsc && now > c->online_tsc) {
+            uint64_t idle = c->idle_tsc;
+            o->idle_pm = (uint32_t)udiv64(idle * 1000u, now - c->online_tsc, 0);
+        }
+        if (o->idle_pm > 1000) o->idle_pm = 1000;
+    }
+    return n;
+}
@@ -0,0 +1,140 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: softirq.c
+ * Descricao: Trabalho adiado de IRQ (softirqs e tasklets)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "softirq.h"
+#include "irqflags.h"
+
+// Voltas extras se novas marcas chegarem enquanto roda; o resto fica para a
+// proxima IRQ ou para o laco ocioso (nao prende a CPU numa rajada).
+#define SOFTIRQ_MAX_RESTART 8
+
+// Estado por CPU (uma so por enquanto: this_cpu() sempre devolve a 0)
+typedef struct {
+    volatile uint32_t pending;
+    tasklet_t* volatile tasklets;   // pilha lock-free (push por CAS)
+    volatile int active;
+} softirq_cpu_t;
+
+static softirq_cpu_t g_cpu[1];
+static softirq_fn_t g_handlers[SOFTIRQ_COUNT];
+static uint32_t g_counts[SOFTIRQ_COUNT];
+
+static inline softirq_cpu_t* this_cpu(void) {
+    return &g_cpu[0];
+}
+
+static void tasklet_action(void);
+
+void softirq_init(void) {
+    softirq_cpu_t* c = this_cpu();
+    c->pending = 0;
+    c->tasklets = 0;
+    c->active = 0;
+    for (int i = 0; i < SOFTIRQ_COUNT; i++) {
+        g_handlers[i] = 0;
+        g_counts[i] = 0;
+    }
+    g_handlers[SOFTIRQ_TASKLET] = tasklet_action;
+}
+
+void softirq_register(int nr, softirq_fn_t fn) {
+    if (nr >= 0 && nr < SOFTIRQ_COUNT) g_handlers[nr] = fn;
+}
+
+void softirq_raise(int nr) {
+    if (nr < 0 || nr >= SOFTIRQ_COUNT) return;
+    __atomic_fetch_or(&this_cpu()->pending, 1u << nr, __ATOMIC_SEQ_CST);
+}
+
+int softirq_pending(void) {
+    return this_cpu()->pending != 0;
+}
+
+int softirq_active(void) {
+    return this_cpu()->active;
+}
+
+uint32_t softirq_count(int nr) {
+    return (nr >= 0 && nr < SOFTIRQ_COUNT) ? g_counts[nr] : 0;
+}
+
+void softirq_run(void) {
+    softirq_cpu_t* c = this_cpu();
+
+    uint32_t flags = irq_save();
+    if (c->active || !c->pending) { irq_restore(flags); return; }
+    c->active = 1;
+    __asm__ volatile("sti");
+
+    for (int round = 0; round < SOFTIRQ_MAX_RESTART; round++) {
+        uint32_t pend = __atomic_exchange_n(&c->pending, 0u, __ATOMIC_SEQ_CST);
+        if (!pend) break;
+        for (int nr = 0; pend; nr++, pend >>= 1) {
+            if (!(pend & 1u) || !g_handlers[nr]) continue;
+            g_counts[nr]++;
+            g_handlers[nr]();
+        }
+    }
+
+    __asm__ volatile("cli");
+    c->active = 0;
+    irq_restore(flags);
+}
+
+void softirq_irq_exit(void) {
+    softirq_cpu_t* c = this_cpu();
+    if (!c->pending || c->active) return;
+    softirq_run();
+}
+
+// ---------------------------------------------------------------------------
+// Tasklets
+// ---------------------------------------------------------------------------
+
+void tasklet_schedule(tasklet_t* t) {
+    if (!t || !t->fn) return;
+    if (__atomic_exchange_n(&t->state, 1u, __ATOMIC_SEQ_CST)) return;   // ja na fila
+
+    softirq_cpu_t* c = this_cpu();
+    tasklet_t* head = c->tasklets;
+    do {
+        t->next = head;
+    } while (!__atomic_compare_exchange_n(&c->tasklets, &head, t, 0,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+    softirq_raise(SOFTIRQ_TASKLET);
+}
+
+static void tasklet_action(void) {
+    softirq_cpu_t* c = this_cpu();
+    tasklet_t* list = __atomic_exchange_n(&c->tasklets, (tasklet_t*)0, __ATOMIC_SEQ_CST);
+
+    // A pilha sai em ordem inversa: desvira para rodar na ordem de agendamento
+    tasklet_t* fifo = 0;
+    while (list) {
+        tasklet_t* n = list->next;
+        list->next = fifo;
+        fifo = list;
+        list = n;
+    }
+
+    while (fifo) {
+        tasklet_t* t = fifo;
+        fifo = t->next;
+        __atomic_store_n(&t->state, 0u, __ATOMIC_SEQ_CST);  // livre para reagendar
+        t->fn(t->arg);
+    }
+}
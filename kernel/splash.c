@@ -17,6 +17,7 @@
 #include "splash.h"
 #include "console.h"
 #include "delay.h"
+#include "fiber.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -122,6 +123,28 @@ static void splash_get_metrics(int* out_padding, int* out_visual_width) {
     *out_visual_width = max_vis_w;
 }
 
+// Spinner ao lado da barra, numa fiber propria: gira enquanto a barra
+// enche e durante a espera final, sem um loop de delay para cada um.
+typedef struct {
+    int col, row;
+    volatile int stop;
+    fiber_event_t done;
+} spinner_t;
+
+static void spinner_fiber(void* arg) {
+    spinner_t* sp = (spinner_t*)arg;
+    static const char frames[4] = { '|', '/', '-', '\\' };
+    for (int i = 0; !sp->stop; i = (i + 1) & 3) {
+        console_set_cursor(sp->col, sp->row);
+        console_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
+        console_putc(frames[i]);
+        fiber_sleep_ms(100);
+    }
+    console_set_cursor(sp->col, sp->row);
+    console_putc(' ');
+    fiber_signal(&sp->done);
+}
+
 void splash_show(uint32_t seconds) {
     // Limpa e prepara
     console_clear();
@@ -203,6 +226,16 @@ void splash_show(uint32_t seconds) {
     int progress_col = (cols - (progress_width + 2)) / 2;
     int progress_row = text_row + version_count + 2;
 
+    spinner_t spin;
+    spin.col = progress_col + progress_width + 3;
+    spin.row = progress_row;
+    spin.stop = 0;
+    spin.done.pending = 0;
+    spin.done.poll = 0;
+    int spinning = 0;
+    if (progress_row < rows && spin.col < cols)
+        spinning = fiber_create("splash", spinner_fiber, &spin) != 0;
+
     if (progress_row < rows) {
         for (int i = 0; i <= progress_width; i++) {
             console_set_cursor(progress_col, progress_row);
@@ -226,10 +259,15 @@ void splash_show(uint32_t seconds) {
             console_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
             console_putc(']');
 
-            delay_ms(150); 
+            fiber_sleep_ms(150);
         }
     }
 
     // Segura na tela
-    delay_time(seconds);
+    fiber_sleep_ms(seconds * 1000u);
+
+    if (spinning) {
+        spin.stop = 1;
+        fiber_wait(&spin.done);
+    }
 }
\ No newline at end of file
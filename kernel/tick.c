@@ -0,0 +1,139 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: tick.c
+ * Descricao: Timer de eventos do kernel: tick periodico ou one-shot (tickless).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "tick.h"
+#include "irqflags.h"
+#include "clock.h"
+#include "pit.h"
+#include "timer.h"
+
+static clockevent_t g_pit_ce = {
+    .name = "pit",
+    .rating = CLOCKEVENT_RATING_PIT,
+    .min_delta_ns = PIT_ONESHOT_MIN_NS,
+    .max_delta_ns = PIT_ONESHOT_MAX_NS,
+    .set_periodic = pit_set_periodic,
+    .set_oneshot = pit_set_oneshot,
+    .shutdown = pit_stop,
+};
+
+static clockevent_t* g_ce = &g_pit_ce;
+static uint32_t g_hz = 1000;
+static int g_nohz = 0;
+
+static uint64_t g_hint = TICK_NEVER;        // prazo mais proximo pedido
+static uint64_t g_programmed = TICK_NEVER;  // quando o one-shot atual dispara
+static volatile uint32_t g_irqs = 0;
+
+// Com IRQs desligadas. Arma o one-shot para o menor entre o proximo timer da
+// roda, a dica pendente e now + max_delta (o IRQ "de seguranca").
+static void program_next(uint64_t now) {
+    if (g_hint <= now) g_hint = TICK_NEVER;
+
+    uint64_t delta = g_ce->max_delta_ns;
+    if (g_hint != TICK_NEVER && g_hint - now < delta) delta = g_hint - now;
+
+    uint32_t exp;
+    if (timer_next_expiry(&exp)) {
+        int32_t left = (int32_t)(exp - clock_ms());
+        uint64_t d = (left > 0) ? (uint64_t)(uint32_t)left * 1000000ull : 0;
+        if (d < delta) delta = d;
+    }
+    if (delta < g_ce->min_delta_ns) delta = g_ce->min_delta_ns;
+
+    g_ce->set_oneshot((uint32_t)delta);
+    g_programmed = now + delta;
+}
+
+void tick_init(uint32_t hz) {
+    if (hz == 0) hz = 1000;
+    g_hz = hz;
+    g_nohz = 0;
+    g_ce->set_periodic(hz);
+}
+
+int tick_register(clockevent_t* ce) {
+    if (!ce || !ce->set_periodic || ce->rating <= g_ce->rating) return 0;
+
+    uint32_t flags = irq_save();
+    if (g_ce->shutdown) g_ce->shutdown();
+    g_ce = ce;
+    if (g_nohz && ce->set_oneshot) {
+        program_next(clock_ns());
+    } else {
+        g_nohz = 0;
+        ce->set_periodic(g_hz);
+    }
+    irq_restore(flags);
+    return 1;
+}
+
+const char* tick_device_name(void) {
+    return g_ce->name;
+}
+
+int tick_set_nohz(int on) {
+    uint32_t flags = irq_save();
+    int ok = 1;
+    if (on) {
+        if (!g_ce->set_oneshot || !clock_is_continuous()) {
+            ok = 0;
+        } else if (!g_nohz) {
+            g_nohz = 1;
+            g_hint = TICK_NEVER;
+            program_next(clock_ns());
+        }
+    } else if (g_nohz) {
+        g_nohz = 0;
+        g_ce->set_periodic(g_hz);
+    }
+    irq_restore(flags);
+    return ok;
+}
+
+int tick_is_nohz(void) {
+    return g_nohz;
+}
+
+void tick_wake_at(uint64_t deadline_ns) {
+    if (!g_nohz) return;
+
+    uint32_t flags = irq_save();
+    if (deadline_ns < g_hint) g_hint = deadline_ns;
+
+    // Reprograma se o prazo e mais cedo que o one-shot armado, ou se o
+    // one-shot ja passou (IRQ perdido/pendente: nao deixa o timer parar).
+    uint64_t now = clock_ns();
+    if (g_programmed <= now || deadline_ns < g_programmed) program_next(now);
+    irq_restore(flags);
+}
+
+void tick_wake_at_ms(uint32_t deadline_ms) {
+    if (!g_nohz) return;
+    int32_t left = (int32_t)(deadline_ms - clock_ms());
+    if (left < 0) left = 0;
+    tick_wake_at(clock_ns() + (uint64_t)(uint32_t)left * 1000000ull);
+}
+
+void tick_irq_exit(void) {
+    g_irqs++;
+    if (g_nohz) program_next(clock_ns());
+}
+
+uint32_t tick_irq_count(void) {
+    return g_irqs;
+}
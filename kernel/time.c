@@ -6,20 +6,39 @@
 
 #include <stdint.h>
 #include "time.h"
-#include "io.h"
-
-// Frequência base do oscilador do chip PIT (1.193182 MHz)
-#define PIT_FREQUENCY 1193180
-
-static volatile uint32_t g_ticks = 0;
+#include "irqflags.h"
+#include "clock.h"
+#include "tick.h"
+#include "timer.h"
+#include "hpet.h"
+#include "irq.h"
+#include "softirq.h"
+#include "math.h"
+
+#define NS_PER_SEC 1000000000u
+
+// Relogio de parede: g_base_sec (segundos Unix) valia exatamente no instante
+// g_ref_ns do clocksource. Nada e incrementado por tick; a hora e calculada
+// quando alguem pede.
+static uint64_t g_base_sec = 0;
+static uint64_t g_ref_ns = 0;
 static volatile uint32_t g_ticks_per_sec = 1000;
-static volatile int g_ready = 0;
 
-static volatile rtc_time_t g_time;
+// Resync pelo RTC: o IRQ8 de fim de update marca a virada exata do segundo
+// do RTC. O primeiro corrige a fase da leitura do boot; depois, a cada
+// TIME_RESYNC_SEC, absorve a deriva entre o clocksource e o cristal do RTC.
+#define TIME_RESYNC_SEC 64u
+static volatile uint64_t g_rtc_edge_ns = 0;
+static volatile uint32_t g_rtc_irqs = 0;
+
+// Data civil e string: convertidas sob demanda e guardadas por segundo.
+static uint64_t g_civil_sec = ~0ull;
+static rtc_time_t g_civil;
+static uint64_t g_str_sec = ~0ull;
+static uint64_t g_consumed_sec = ~0ull;
 
 // Buffer estatico: "HH:MM:SS DD/MM/YYYY" + '\0' => 20
 static char g_time_str[20];
-static volatile int g_time_str_dirty = 1;
 
 static inline void put2(char *p, uint8_t v) {
     p[0] = (char)('0' + (v / 10));
@@ -33,50 +52,108 @@ static inline void put4(char *p, uint16_t v) {
     p[3] = (char)('0' + (v % 10));
 }
 
-static void rebuild_time_str(void) {
-    // "HH:MM:SS DD/MM/YYYY"
-    put2(&g_time_str[0],  g_time.hour);
-    g_time_str[2] = ':';
-    put2(&g_time_str[3],  g_time.min);
-    g_time_str[5] = ':';
-    put2(&g_time_str[6],  g_time.sec);
-    g_time_str[8] = ' ';
-    put2(&g_time_str[9],  g_time.day);
-    g_time_str[11] = '/';
-    put2(&g_time_str[12], g_time.mon);
-    g_time_str[14] = '/';
-    put4(&g_time_str[15], g_time.year);
-    g_time_str[19] = '\0';
+// ---------------------------------------------------------------------------
+// Calendario (gregoriano proleptico, dias desde 1970-01-01)
+// ---------------------------------------------------------------------------
+
+static uint32_t days_from_civil(uint32_t y, uint32_t m, uint32_t d) {
+    y -= (m <= 2);
+    uint32_t era = y / 400;
+    uint32_t yoe = y - era * 400;
+    uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
 }
 
-static void tick_one_second(void) {
-    g_time.sec++;
-    if (g_time.sec >= 60) {
-        g_time.sec = 0;
-        g_time.min++;
-        if (g_time.min >= 60) {
-            g_time.min = 0;
-            g_time.hour++;
-            if (g_time.hour >= 24) {
-                g_time.hour = 0;
-                // g_time.day++; // Calendário completo requer lógica de bissexto
-            }
-        }
-    }
-    rebuild_time_str();
-    g_time_str_dirty = 1;
+static void civil_from_days(uint32_t z, rtc_time_t *t) {
+    z += 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    t->day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    t->mon = (uint8_t)m;
+    t->year = (uint16_t)(yoe + era * 400 + (m <= 2));
 }
 
-// Handler chamado pelo IRQ0
-void time_tick(void) {
-    g_ticks++;
+static uint64_t rtc_to_epoch(const rtc_time_t *t) {
+    uint64_t days = days_from_civil(t->year, t->mon ? t->mon : 1, t->day ? t->day : 1);
+    return days * 86400u + (uint32_t)t->hour * 3600u + (uint32_t)t->min * 60u + t->sec;
+}
+
+static void epoch_to_rtc(uint64_t sec, rtc_time_t *t) {
+    uint64_t rem;
+    uint32_t days = (uint32_t)udiv64(sec, 86400u, &rem);
+    uint32_t s = (uint32_t)rem;
+    t->hour = (uint8_t)(s / 3600u);
+    t->min = (uint8_t)((s / 60u) % 60u);
+    t->sec = (uint8_t)(s % 60u);
+    civil_from_days(days, t);
+}
+
+// ---------------------------------------------------------------------------
+// Resync pelo RTC (IRQ8)
+// ---------------------------------------------------------------------------
+
+static void set_base(uint64_t sec, uint64_t ref_ns) {
+    uint32_t flags = irq_save();
+    g_base_sec = sec;
+    g_ref_ns = ref_ns;
+    irq_restore(flags);
+}
+
+// Tasklet: le os campos do RTC (estaveis por ~1s depois do IRQ) e ancora o
+// relogio na borda registrada pelo IRQ.
+static void rtc_resync_tasklet(void* arg) {
+    (void)arg;
+    uint64_t edge = g_rtc_edge_ns;
+    if (clock_ns() - edge > 900000000ull) return;   // atrasou demais: o RTC ja virou de novo
+    rtc_time_t t;
+    if (!cmos_read_rtc_now(&t)) return;
+    set_base(rtc_to_epoch(&t), edge);
+}
 
-    if (!g_ready) return;
+static tasklet_t g_resync_tasklet = TASKLET_INIT(rtc_resync_tasklet, 0);
 
-    // Atualiza o relógio a cada segundo real
-    if ((g_ticks_per_sec != 0) && ((g_ticks % g_ticks_per_sec) == 0)) {
-        tick_one_second();
+static void rtc_irq(regs_t *r) {
+    (void)r;
+    uint8_t c = cmos_rtc_irq_ack();
+    if (!(c & 0x10)) return;                // nao e fim de update
+    uint32_t n = g_rtc_irqs++;
+    if (n % TIME_RESYNC_SEC) return;
+    g_rtc_edge_ns = clock_ns();
+    tasklet_schedule(&g_resync_tasklet);
+}
+
+// Sem IRQ8 (HPET no roteamento legado): o flag UF do registrador C liga a
+// cada fim de update mesmo sem interrupcao. A cada TIME_RESYNC_SEC um timer
+// descarta o UF velho e procura o proximo a cada RTC_POLL_MS; a borda sai
+// com ate RTC_POLL_MS de atraso e vai para o mesmo tasklet.
+#define RTC_POLL_MS 1u
+static int g_rtc_hunt = 0;
+
+static void rtc_poll(void *arg) {
+    (void)arg;
+    uint8_t c = cmos_rtc_irq_ack();
+    if (!hpet_owns_irq8()) return;          // IRQ8 voltou: o rtc_irq assume
+
+    uint32_t now = time_get_ticks();
+    if (g_rtc_hunt && (c & 0x10)) {
+        g_rtc_hunt = 0;
+        g_rtc_edge_ns = clock_ns();
+        tasklet_schedule(&g_resync_tasklet);
+        timer_add(now + TIME_RESYNC_SEC * 1000u - 500u, rtc_poll, 0);
+        return;
     }
+    g_rtc_hunt = 1;
+    timer_add(now + RTC_POLL_MS, rtc_poll, 0);
+}
+
+// Handler chamado pelo IRQ0
+void time_tick(void) {
+    clock_tick();
 }
 
 // AQUI ESTAVA O ERRO: Faltava programar o chip PIT!
@@ -86,47 +163,84 @@ void time_init(uint32_t pit_ticks_per_sec) {
     // 1. Atualiza a variável do Kernel
     g_ticks_per_sec = pit_ticks_per_sec;
 
-    // 2. Calcula o Divisor (Hardware)
-    uint32_t divisor = PIT_FREQUENCY / pit_ticks_per_sec;
+    // 2. Programa o canal 0 do PIT (IRQ0 periodico)
+    tick_init(pit_ticks_per_sec);
 
-    // 3. Envia Comandos para o Chip PIT (Isso que faltava)
-    outb(0x43, 0x36); // Modo 3 (Square Wave)
-    
-    uint8_t l = (uint8_t)(divisor & 0xFF);
-    uint8_t h = (uint8_t)((divisor >> 8) & 0xFF);
+    // 3. Clocksources: ticks do PIT + TSC calibrado no canal 2
+    clock_init(pit_ticks_per_sec);
+
+    //    HPET (ACPI): clocksource e, sem timer do LAPIC, o IRQ0 (tirando
+    //    o IRQ8 do RTC enquanto for o tick)
+    hpet_init();
 
-    outb(0x40, l);    // Low Byte
-    outb(0x40, h);    // High Byte
+    // 4. Com um clocksource continuo o IRQ0 vira one-shot (tickless);
+    //    sem TSC continua periodico.
+    tick_set_nohz(1);
 
-    // 4. Inicializa RTC
+    // 5. Hora de parede: uma leitura do RTC no boot, depois so o IRQ8 (ou
+    //    o polling do rtc_poll enquanto o HPET ocupa a linha)
     rtc_time_t t;
     cmos_read_rtc(&t);
-    g_time = t;
+    set_base(rtc_to_epoch(&t), clock_ns());
+
+    irq_install_handler(8, rtc_irq);
+    cmos_rtc_irq_enable();
+    irq_unmask(2);                          // cascata do 8259 escravo
+    irq_unmask(8);
+
+    // 6. Roda de timers
+    timer_init();
+    if (hpet_owns_irq8()) timer_add(time_get_ticks(), rtc_poll, 0);
+}
 
-    rebuild_time_str();
-    g_time_str_dirty = 1;
-    g_ready = 1;
+uint64_t time_epoch(void) {
+    uint64_t now = clock_ns();
+    uint32_t flags = irq_save();
+    uint64_t base = g_base_sec, ref = g_ref_ns;
+    irq_restore(flags);
+    if (now <= ref) return base;
+    return base + udiv64(now - ref, NS_PER_SEC, 0);
 }
 
 rtc_time_t time_now(void) {
-    rtc_time_t t = g_time;
-    return t;
+    uint64_t sec = time_epoch();
+    if (sec != g_civil_sec) {
+        epoch_to_rtc(sec, &g_civil);
+        g_civil_sec = sec;
+    }
+    return g_civil;
 }
 
 const char *time_datetime_str(void) {
+    rtc_time_t t = time_now();
+    if (g_str_sec == g_civil_sec) return g_time_str;
+    g_str_sec = g_civil_sec;
+
+    // "HH:MM:SS DD/MM/YYYY"
+    put2(&g_time_str[0],  t.hour);
+    g_time_str[2] = ':';
+    put2(&g_time_str[3],  t.min);
+    g_time_str[5] = ':';
+    put2(&g_time_str[6],  t.sec);
+    g_time_str[8] = ' ';
+    put2(&g_time_str[9],  t.day);
+    g_time_str[11] = '/';
+    put2(&g_time_str[12], t.mon);
+    g_time_str[14] = '/';
+    put4(&g_time_str[15], t.year);
+    g_time_str[19] = '\0';
     return g_time_str;
 }
 
 int time_has_update(void) {
-    return g_time_str_dirty ? 1 : 0;
+    return time_epoch() != g_consumed_sec;
 }
 
 void time_consume_update(void) {
-    g_time_str_dirty = 0;
+    g_consumed_sec = time_epoch();
 }
 
-// Retorna o número de Ticks (ms) desde o boot
-// Adicione isso no final do arquivo time.c
+// Milissegundos desde o boot (vem do clocksource, nao da contagem de IRQs)
 uint32_t time_get_ticks(void) {
-    return g_ticks;
-}
\ No newline at end of file
+    return clock_ms();
+}
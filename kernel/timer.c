@@ -0,0 +1,268 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: timer.c
+ * Descricao: Timers do kernel sobre uma roda hierarquica (insercao/expiracao O(1)).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "timer.h"
+#include "irqflags.h"
+#include "time.h"
+#include "tick.h"
+#include "softirq.h"
+#include "math.h"
+
+// Roda hierarquica (estilo "cascading timer wheel"):
+//   tv1: 256 slots de 1ms   -> prazos ate 256ms
+//   tv2..tv5: 64 slots cada -> 2^14, 2^20, 2^26 e 2^32 ms
+// Inserir e O(1) (so calcula o slot). A cada volta do tv1 o proximo slot do
+// nivel de cima e redistribuido ("cascade") para baixo.
+#define TVR_BITS 8
+#define TVN_BITS 6
+#define TVR_SIZE (1u << TVR_BITS)
+#define TVN_SIZE (1u << TVN_BITS)
+#define TVR_MASK (TVR_SIZE - 1u)
+#define TVN_MASK (TVN_SIZE - 1u)
+#define TVN_LEVELS 4
+
+#define TIMER_FREE    0
+#define TIMER_PENDING 1
+
+struct ktimer {
+    struct ktimer*  next;
+    struct ktimer** pprev;      // campo que aponta para este (remocao O(1))
+    uint32_t expires;
+    uint32_t period;            // 0 = one-shot
+    timer_fn_t fn;
+    void* arg;
+    uint8_t state;
+};
+
+static ktimer_t* g_tv1[TVR_SIZE];
+static ktimer_t* g_tvn[TVN_LEVELS][TVN_SIZE];
+
+static ktimer_t g_pool[TIMER_POOL_SIZE];
+static ktimer_t* g_free = 0;
+
+static uint32_t g_base = 0;         // proximo ms a processar
+static uint32_t g_count = 0;        // timers pendentes
+static uint32_t g_next = 0;         // limite inferior do proximo prazo
+static int g_next_valid = 0;
+static volatile int g_running = 0;
+
+static void list_add(ktimer_t** slot, ktimer_t* t) {
+    t->next = *slot;
+    if (t->next) t->next->pprev = &t->next;
+    *slot = t;
+    t->pprev = slot;
+}
+
+static void list_del(ktimer_t* t) {
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    t->next = 0;
+    t->pprev = 0;
+}
+
+static void internal_add(ktimer_t* t) {
+    uint32_t exp = t->expires;
+    uint32_t idx = exp - g_base;
+    ktimer_t** slot;
+
+    if ((int32_t)idx < 0) {
+        slot = &g_tv1[g_base & TVR_MASK];          // ja venceu: proximo slot
+    } else if (idx < (1u << TVR_BITS)) {
+        slot = &g_tv1[exp & TVR_MASK];
+    } else if (idx < (1u << (TVR_BITS + TVN_BITS))) {
+        slot = &g_tvn[0][(exp >> TVR_BITS) & TVN_MASK];
+    } else if (idx < (1u << (TVR_BITS + 2 * TVN_BITS))) {
+        slot = &g_tvn[1][(exp >> (TVR_BITS + TVN_BITS)) & TVN_MASK];
+    } else if (idx < (1u << (TVR_BITS + 3 * TVN_BITS))) {
+        slot = &g_tvn[2][(exp >> (TVR_BITS + 2 * TVN_BITS)) & TVN_MASK];
+    } else {
+        slot = &g_tvn[3][(exp >> (TVR_BITS + 3 * TVN_BITS)) & TVN_MASK];
+    }
+    list_add(slot, t);
+
+    if (g_next_valid && time_reached_u32(exp, g_next)) return;   // ja ha prazo mais cedo
+    g_next = ((int32_t)idx < 0) ? g_base : exp;
+    g_next_valid = 1;
+}
+
+// Redistribui um slot do nivel n para os niveis de baixo. Retorna o indice
+// (0 = esse nivel tambem deu a volta, continua no de cima).
+static uint32_t cascade(int n, uint32_t index) {
+    ktimer_t* t = g_tvn[n][index];
+    g_tvn[n][index] = 0;
+    while (t) {
+        ktimer_t* nx = t->next;
+        t->next = 0;
+        t->pprev = 0;
+        internal_add(t);
+        t = nx;
+    }
+    return index;
+}
+
+#define TV_INDEX(n) ((g_base >> (TVR_BITS + (n) * TVN_BITS)) & TVN_MASK)
+
+// Menor prazo possivel: primeiro slot ocupado do tv1 ate a proxima volta
+// (onde um cascade pode trazer timers dos niveis de cima).
+static void compute_next(void) {
+    uint32_t i = 0;
+    do {
+        if (g_tv1[(g_base + i) & TVR_MASK]) break;
+        i++;
+    } while (((g_base + i) & TVR_MASK) != 0);
+    g_next = g_base + i;
+    g_next_valid = 1;
+}
+
+static ktimer_t* pool_get(void) {
+    ktimer_t* t = g_free;
+    if (t) g_free = t->next;
+    return t;
+}
+
+static void pool_put(ktimer_t* t) {
+    t->state = TIMER_FREE;
+    t->fn = 0;
+    t->next = g_free;
+    g_free = t;
+}
+
+static void timer_softirq(void) {
+    timer_run(time_get_ticks());
+}
+
+void timer_init(void) {
+    g_free = 0;
+    for (int i = TIMER_POOL_SIZE - 1; i >= 0; i--) {
+        g_pool[i].state = TIMER_FREE;
+        g_pool[i].next = g_free;
+        g_free = &g_pool[i];
+    }
+    for (uint32_t i = 0; i < TVR_SIZE; i++) g_tv1[i] = 0;
+    for (int n = 0; n < TVN_LEVELS; n++)
+        for (uint32_t i = 0; i < TVN_SIZE; i++) g_tvn[n][i] = 0;
+
+    g_base = time_get_ticks();
+    g_count = 0;
+    g_next_valid = 0;
+    softirq_register(SOFTIRQ_TIMER, timer_softirq);
+}
+
+ktimer_t* timer_add_periodic(uint32_t first, uint32_t period_ms, timer_fn_t cb, void* arg) {
+    if (!cb) return 0;
+
+    uint32_t flags = irq_save();
+    ktimer_t* t = pool_get();
+    if (t) {
+        t->expires = first;
+        t->period = period_ms;
+        t->fn = cb;
+        t->arg = arg;
+        t->state = TIMER_PENDING;
+        internal_add(t);
+        g_count++;
+    }
+    irq_restore(flags);
+
+    // Tickless: o one-shot armado pode estar depois desse prazo
+    if (t) tick_wake_at_ms(first);
+    return t;
+}
+
+ktimer_t* timer_add(uint32_t deadline, timer_fn_t cb, void* arg) {
+    return timer_add_periodic(deadline, 0, cb, arg);
+}
+
+int timer_cancel(ktimer_t* t) {
+    if (!t) return 0;
+    uint32_t flags = irq_save();
+    int was = (t->state == TIMER_PENDING && t->pprev);
+    if (was) {
+        list_del(t);
+        g_count--;
+        pool_put(t);
+    }
+    irq_restore(flags);
+    return was;
+}
+
+int timer_due(uint32_t now) {
+    if (g_count == 0 || g_running) return 0;
+    if (!g_next_valid) compute_next();
+    return time_reached_u32(now, g_next);
+}
+
+int timer_next_expiry(uint32_t* deadline) {
+    uint32_t flags = irq_save();
+    int any = (g_count != 0);
+    if (any) {
+        if (!g_next_valid) compute_next();
+        if (deadline) *deadline = g_next;
+    }
+    irq_restore(flags);
+    return any;
+}
+
+void timer_run(uint32_t now) {
+    uint32_t flags = irq_save();
+    if (g_running) { irq_restore(flags); return; }
+    g_running = 1;
+
+    while (time_reached_u32(now, g_base)) {
+        if (g_count == 0) {
+            g_base = now + 1;   // nada para cascatear: pula direto
+            break;
+        }
+
+        uint32_t idx = g_base & TVR_MASK;
+        if (idx == 0 &&
+            !cascade(0, TV_INDEX(0)) &&
+            !cascade(1, TV_INDEX(1)) &&
+            !cascade(2, TV_INDEX(2))) {
+            cascade(3, TV_INDEX(3));
+        }
+        g_base++;
+
+        ktimer_t* t;
+        while ((t = g_tv1[idx]) != 0) {
+            list_del(t);
+            timer_fn_t fn = t->fn;
+            void* arg = t->arg;
+
+            if (t->period) {
+                // Sem deriva; se ficou para tras (IRQs desligadas muito
+                // tempo), recomeca a partir de agora em vez de disparar em rajada.
+                t->expires += t->period;
+                if (time_reached_u32(now, t->expires)) t->expires = now + t->period;
+                internal_add(t);
+            } else {
+                g_count--;
+                pool_put(t);
+            }
+
+            // Callback com as interrupcoes como o chamador deixou (ligadas
+            // no fim do IRQ)
+            irq_restore(flags);
+            fn(arg);
+            flags = irq_save();
+        }
+    }
+
+    g_next_valid = 0;
+    g_running = 0;
+    irq_restore(flags);
+}
@@ -15,14 +15,69 @@
  ****************************************************************************/
 
 #include "tss.h"
+#include "irqflags.h"
 #include "gdt.h"
 
-// tss is defined in ASM (boot/boot_gdt.s)
-extern tss_entry_t tss;
+typedef struct __attribute__((aligned(16))) cpu_gdt {
+    uint64_t gdt[4];
+    tss_entry_t tss;
+} cpu_gdt_t;
 
+static cpu_gdt_t g_cpu_gdt[TSS_MAX_CPUS];
+
+// Available 32-bit TSS descriptor (type 9, DPL 0, byte granularity)
+static uint64_t tss_descriptor(uint32_t base, uint32_t limit) {
+    uint64_t d = limit & 0xFFFFu;
+    d |= (uint64_t)(base & 0xFFFFFFu) << 16;
+    d |= (uint64_t)0x89 << 40;
+    d |= (uint64_t)((limit >> 16) & 0xFu) << 48;
+    d |= (uint64_t)(base >> 24) << 56;
+    return d;
+}
+
+void tss_cpu_init(int cpu, uint32_t stack_top) {
+    if (cpu < 0 || cpu >= TSS_MAX_CPUS) return;
+    cpu_gdt_t* g = &g_cpu_gdt[cpu];
+
+    uint8_t* p = (uint8_t*)&g->tss;
+    for (uint32_t i = 0; i < sizeof(tss_entry_t); i++) p[i] = 0;
+    g->tss.esp0 = stack_top;
+    g->tss.ss0  = GDT_KDATA_SEL;
+    g->tss.iomap_base = sizeof(tss_entry_t);    // no I/O bitmap
+
+    g->gdt[0] = 0;
+    g->gdt[1] = 0x00CF9A000000FFFFull;          // 0x08: code (base=0, limit=4GB)
+    g->gdt[2] = 0x00CF92000000FFFFull;          // 0x10: data (base=0, limit=4GB)
+    g->gdt[3] = tss_descriptor((uint32_t)(uintptr_t)&g->tss, sizeof(tss_entry_t) - 1);
+
+    struct __attribute__((packed)) {
+        uint16_t limit;
+        uint32_t base;
+    } gdtr = { sizeof(g->gdt) - 1, (uint32_t)(uintptr_t)&g->gdt[0] };
+
+    uint32_t flags = irq_save();
+    __asm__ volatile(
+        "lgdt %0\n"
+        "ljmp $0x08, $1f\n"
+        "1:\n"
+        "movw $0x10, %%ax\n"
+        "movw %%ax, %%ds\n"
+        "movw %%ax, %%es\n"
+        "movw %%ax, %%fs\n"
+        "movw %%ax, %%gs\n"
+        "movw %%ax, %%ss\n"
+        "movw $0x18, %%ax\n"
+        "ltr %%ax\n"
+        :: "m"(gdtr) : "eax", "memory");
+    irq_restore(flags);
+}
+
+tss_entry_t* tss_cpu(int cpu) {
+    if (cpu < 0 || cpu >= TSS_MAX_CPUS) return 0;
+    return &g_cpu_gdt[cpu].tss;
+}
+
+// Boot CPU only (single-CPU callers)
 void tss_set_kernel_stack(uint32_t stack_top) {
-    // Minimal setup: only ring0 stack fields are important now
-    tss.esp0 = stack_top;
-    tss.ss0  = 0x10;
-    tss.iomap_base = sizeof(tss_entry_t);
+    g_cpu_gdt[0].tss.esp0 = stack_top;
 }
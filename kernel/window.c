@@ -20,6 +20,9 @@
 #include "video.h"
 #include "font.h"
 #include "window.h"
+#include "compositor.h"
+#include "timer.h"
+#include "event.h"
 
 // Ticks (ms) desde o boot (time.c). Não há header público no projeto.
 extern uint32_t time_get_ticks(void);
@@ -34,17 +37,19 @@ extern void __desktop_set_focused(struct Window* w);
 // Helpers de memória
 static size_t kstrlen(const char* s) { size_t n=0; while (s && s[n]) n++; return n; }
 static void* kmemset(void* p, int v, size_t n){ uint8_t* b=(uint8_t*)p; for(size_t i=0;i<n;i++) b[i]=(uint8_t)v; return p; }
-static void* kmemcpy(void* d, const void* s, size_t n){ uint8_t* dd=(uint8_t*)d; const uint8_t* ss=(const uint8_t*)s; for(size_t i=0;i<n;i++) dd[i]=ss[i]; return d; }
-static void* kmemmove(void* d, const void* s, size_t n){
-    uint8_t* dd=(uint8_t*)d; const uint8_t* ss=(const uint8_t*)s;
-    if (dd==ss || n==0) return d;
-    if (dd < ss){ for(size_t i=0;i<n;i++) dd[i]=ss[i]; }
-    else { for(size_t i=n;i>0;i--) dd[i-1]=ss[i-1]; }
-    return d;
-}
 
 #define WIN_MAX_TITLE  48
-#define WIN_LOG_BYTES  2048
+
+#define WIN_BORDER     2
+#define WIN_TITLE_H    18
+#define WIN_BTN        14
+#define WIN_LINE_H     10
+#define WIN_BLINK_MS   500
+
+// Layout do texto: anel de linhas já quebradas (potência de 2).
+#define WIN_MAX_LINES  64
+#define WIN_MAX_COLS   240
+#define LINE_IDX(seq)  ((seq) & (WIN_MAX_LINES - 1))
 
 typedef struct Window {
     int x, y, w, h;
@@ -52,56 +57,98 @@ typedef struct Window {
     int z;
     int focused;
     char title[WIN_MAX_TITLE];
-    char log[WIN_LOG_BYTES];
-    size_t log_len;
     void (*on_key)(char c);
     struct Window* next;
+
+    // Superficie propria (w*h, 0x00RRGGBB). So e redesenhada quando `dirty`;
+    // o compositor copia dela para a tela apenas o que estiver visivel.
+    comp_layer_t layer;
+    uint32_t* surface;
+    int dirty;
+    int cursor_phase;
+
+    // Layout incremental: window_write aplica \n, wrap e \b só na cauda.
+    // Linhas são identificadas por um número de sequência crescente.
+    int cols;
+    char line_text[WIN_MAX_LINES][WIN_MAX_COLS];
+    uint8_t line_len[WIN_MAX_LINES];
+    uint32_t line_first;        // linha mais antiga ainda guardada
+    uint32_t line_last;         // linha atual (cauda)
+    int has_cursor;             // cursor acompanha a cauda do texto
+    uint32_t cursor_line;
+    int cursor_col;
+    int text_dirty;
+    uint32_t text_dirty_from;   // primeira linha alterada desde o último render
+    uint32_t view_last;         // line_last no último render (detecta scroll)
 } Window;
 
 static Window* g_head = NULL;
 static int g_z_counter = 1;
 static Window* g_focused = NULL;
 
-// Wrapper direto para evitar overhead
-static inline void putpix(int x, int y, uint32_t c){ 
-    put_pixel(x,y,c); 
+// Fase do cursor piscando: um timer periódico troca e acorda o desktop.
+static volatile int g_blink_phase = 1;
+static ktimer_t* g_blink_timer = 0;
+
+static void blink_timer(void* arg){
+    (void)arg;
+    g_blink_phase ^= 1;
+    if(g_focused && !g_focused->closed && g_focused->has_cursor) event_post_timer();
 }
 
-static void fill_rect(int x, int y, int w, int h, uint32_t c){
-    draw_rect(x,y,w,h,c);
+static void blink_start(void){
+    if(g_blink_timer) return;
+    g_blink_timer = timer_add_periodic(time_get_ticks() + WIN_BLINK_MS, WIN_BLINK_MS, blink_timer, 0);
 }
 
-// Otimização: Desenha char checando bits mais rápido
-static void draw_char8(int x, int y, char ch, uint32_t fg){
+// Desenho na superficie da janela (coordenadas locais, com clip)
+static void surf_fill(Window* w, int x, int y, int fw, int fh, uint32_t c){
+    if(x < 0){ fw += x; x = 0; }
+    if(y < 0){ fh += y; y = 0; }
+    if(x + fw > w->w) fw = w->w - x;
+    if(y + fh > w->h) fh = w->h - y;
+    if(fw <= 0 || fh <= 0) return;
+    for(int yy=0; yy<fh; yy++){
+        uint32_t* row = w->surface + (uint32_t)(y + yy) * (uint32_t)w->w + (uint32_t)x;
+        for(int xx=0; xx<fw; xx++) row[xx] = c;
+    }
+}
+
+static void draw_char8(Window* w, int x, int y, char ch, uint32_t fg){
     uint8_t c = (uint8_t)ch;
     if (c >= 128) c = '?';
+    if (x < 0 || y < 0 || x + 8 > w->w || y + 8 > w->h) return;
     const uint8_t* glyph = font8x8_basic[c];
     
     for(int row=0; row<8; row++){
         uint8_t bits = glyph[row];
-        // Loop desenrolado ou simples, mas evitando contas desnecessárias
-        int py = y + row;
-        if(bits & 0x01) putpix(x+7, py, fg);
-        if(bits & 0x02) putpix(x+6, py, fg);
-        if(bits & 0x04) putpix(x+5, py, fg);
-        if(bits & 0x08) putpix(x+4, py, fg);
-        if(bits & 0x10) putpix(x+3, py, fg);
-        if(bits & 0x20) putpix(x+2, py, fg);
-        if(bits & 0x40) putpix(x+1, py, fg);
-        if(bits & 0x80) putpix(x+0, py, fg);
+        if(!bits) continue;
+        uint32_t* p = w->surface + (uint32_t)(y + row) * (uint32_t)w->w + (uint32_t)x;
+        if(bits & 0x80) p[0] = fg;
+        if(bits & 0x40) p[1] = fg;
+        if(bits & 0x20) p[2] = fg;
+        if(bits & 0x10) p[3] = fg;
+        if(bits & 0x08) p[4] = fg;
+        if(bits & 0x04) p[5] = fg;
+        if(bits & 0x02) p[6] = fg;
+        if(bits & 0x01) p[7] = fg;
     }
 }
 
-static void draw_text8(int x, int y, const char* s, uint32_t fg){
+static void draw_text8(Window* w, int x, int y, const char* s, uint32_t fg){
     int cx = x;
     for(size_t i=0; s && s[i]; i++){
         if (s[i]=='\n'){ y += 10; cx = x; continue; }
-        draw_char8(cx, y, s[i], fg);
+        draw_char8(w, cx, y, s[i], fg);
         cx += 8;
     }
 }
 
-static void win_bring_to_front(Window* w){ if(!w) return; w->z = ++g_z_counter; }
+static void win_bring_to_front(Window* w){
+    if(!w) return;
+    w->z = ++g_z_counter;
+    comp_layer_raise(&w->layer);
+}
 
 static Window* win_topmost(void){
     Window* best=NULL;
@@ -127,23 +174,92 @@ static Window* win_next_after(Window* cur){
 }
 
 static void win_set_focus(Window* w){
-    if(g_focused) g_focused->focused=0;
+    if(g_focused){ g_focused->focused=0; g_focused->dirty=1; }
     g_focused=w;
     if(g_focused){
         g_focused->focused=1;
+        g_focused->dirty=1;
         win_bring_to_front(g_focused);
     }
     __desktop_set_focused(g_focused);
 }
 
+static void client_rect(const Window* w, int* cx, int* cy, int* cw, int* ch){
+    *cx = WIN_BORDER;
+    *cy = WIN_BORDER + WIN_TITLE_H;
+    *cw = w->w - WIN_BORDER*2;
+    *ch = w->h - WIN_BORDER*2 - WIN_TITLE_H;
+}
+
+static void layout_touch(Window* w, uint32_t seq){
+    if(!w->text_dirty || seq < w->text_dirty_from) w->text_dirty_from = seq;
+    w->text_dirty = 1;
+}
+
+static void layout_newline(Window* w){
+    w->line_last++;
+    if(w->line_last - w->line_first >= WIN_MAX_LINES) w->line_first++;
+    w->line_len[LINE_IDX(w->line_last)] = 0;
+    layout_touch(w, w->line_last);
+}
+
+static void layout_putc(Window* w, unsigned char c){
+    uint32_t li = LINE_IDX(w->line_last);
+
+    if(c == '\r') return;
+
+    if(c == '\n'){ layout_newline(w); return; }
+
+    if(c == '\b'){
+        // backspace: remove um char da linha atual
+        if(w->line_len[li] > 0){
+            w->line_len[li]--;
+            if(w->has_cursor && w->cursor_line == w->line_last && w->cursor_col > w->line_len[li])
+                w->cursor_col = w->line_len[li];
+            layout_touch(w, w->line_last);
+        }
+        return;
+    }
+
+    // Apenas imprimíveis básicos
+    if(c < 32 || c > 126) return;
+
+    if(w->line_len[li] >= w->cols){
+        layout_newline(w);
+        li = LINE_IDX(w->line_last);
+    }
+    w->line_text[li][w->line_len[li]++] = (char)c;
+    layout_touch(w, w->line_last);
+}
+
 Window* window_make(const char* title, int x, int y, int w, int h){
     if(!title || w < 120 || h < 80) return NULL;
     Window* win=(Window*)kmalloc((uint32_t)sizeof(Window));
     if(!win) return NULL;
     kmemset(win, 0, sizeof(Window));
 
+    win->surface=(uint32_t*)kmalloc((uint32_t)w * (uint32_t)h * 4u);
+    if(!win->surface){ kfree(win); return NULL; }
+
     win->x=x; win->y=y; win->w=w; win->h=h;
     win->z=++g_z_counter;
+    win->dirty=1;
+    win->cursor_phase=-1;
+
+    // Colunas visíveis (fonte 8px + padding). Mantém o texto DENTRO da janela.
+    win->cols = (w - WIN_BORDER*2 - 8) / 8;
+    if(win->cols < 1) win->cols = 1;
+    if(win->cols > WIN_MAX_COLS) win->cols = WIN_MAX_COLS;
+
+    win->layer.x=x; win->layer.y=y; win->layer.w=w; win->layer.h=h;
+    win->layer.pixels=win->surface;
+    win->layer.visible=1;
+    // Sem camada a janela nao seria desenhada nem clicavel: falha aqui
+    if(comp_layer_add(&win->layer) < 0){
+        kfree(win->surface);
+        kfree(win);
+        return NULL;
+    }
 
     size_t n=0;
     while(title[n] && n < WIN_MAX_TITLE-1){ win->title[n]=title[n]; n++; }
@@ -152,6 +268,7 @@ Window* window_make(const char* title, int x, int y, int w, int h){
     win->next=g_head;
     g_head=win;
     win_set_focus(win);
+    blink_start();
     return win;
 }
 
@@ -163,7 +280,9 @@ void window_close(Window* win){
         if(*pp==win){ *pp=win->next; break; }
         pp=&((*pp)->next);
     }
-    if(g_focused==win) win_set_focus(win_topmost());
+    comp_layer_remove(&win->layer);
+    if(g_focused==win){ g_focused=NULL; win_set_focus(win_topmost()); }
+    kfree(win->surface);
     kfree(win);
 }
 
@@ -177,25 +296,75 @@ void window_focus(Window* win){
     win_set_focus(win);
 }
 
+// Move o cursor para a cauda (fim da linha atual), sujando as duas posições.
+static void cursor_follow_tail(Window* w){
+    if(!w->has_cursor) return;
+    int col = w->line_len[LINE_IDX(w->line_last)];
+    if(w->cursor_line == w->line_last && w->cursor_col == col) return;
+    layout_touch(w, w->cursor_line);
+    w->cursor_line = w->line_last;
+    w->cursor_col = col;
+    layout_touch(w, w->line_last);
+}
+
+Window* window_at(int x, int y){
+    Window* best=NULL;
+    for(Window* it=g_head; it; it=it->next){
+        if(it->closed) continue;
+        if(x < it->x || y < it->y || x >= it->x + it->w || y >= it->y + it->h) continue;
+        if(!best || it->z > best->z) best=it;
+    }
+    return best;
+}
+
+int window_hit(Window* win, int x, int y){
+    if(!win || win->closed) return WINDOW_HIT_NONE;
+    int lx = x - win->x, ly = y - win->y;
+    if(lx < 0 || ly < 0 || lx >= win->w || ly >= win->h) return WINDOW_HIT_NONE;
+
+    int bx = win->w - WIN_BORDER - WIN_BTN - 2;
+    int by = WIN_BORDER + 2;
+    if(lx >= bx && lx < bx + WIN_BTN && ly >= by && ly < by + WIN_BTN) return WINDOW_HIT_CLOSE;
+    if(ly < WIN_BORDER + WIN_TITLE_H) return WINDOW_HIT_TITLE;
+    return WINDOW_HIT_CLIENT;
+}
+
+void window_get_pos(Window* win, int* x, int* y){
+    if(!win) return;
+    if(x) *x = win->x;
+    if(y) *y = win->y;
+}
+
+// Mover não re-renderiza: o compositor copia os pixels da tela.
+void window_move(Window* win, int x, int y){
+    if(!win || win->closed) return;
+    win->x = x;
+    win->y = y;
+    comp_layer_move(&win->layer, x, y);
+}
+
+// Escrita em lote: O(len), só a cauda do layout é tocada.
+void window_write_n(Window* win, const char* buf, size_t len){
+    if(!win || !buf || !len) return;
+
+    for(size_t i=0; i<len; i++) layout_putc(win, (unsigned char)buf[i]);
+    cursor_follow_tail(win);
+}
+
 void window_write(Window* win, const char* text){
     if(!win || !text) return;
-    size_t tlen=kstrlen(text);
-    if(!tlen) return;
-
-    if(tlen >= WIN_LOG_BYTES){
-        text += (tlen - (WIN_LOG_BYTES-1));
-        tlen = WIN_LOG_BYTES-1;
-        win->log_len = 0;
-    } else if (win->log_len + tlen >= WIN_LOG_BYTES){
-        size_t overflow = (win->log_len + tlen) - (WIN_LOG_BYTES - 1);
-        if (overflow > win->log_len) overflow = win->log_len;
-        kmemmove(win->log, win->log + overflow, win->log_len - overflow);
-        win->log_len -= overflow;
-    }
+    window_write_n(win, text, kstrlen(text));
+}
 
-    kmemcpy(win->log + win->log_len, text, tlen);
-    win->log_len += tlen;
-    win->log[win->log_len]=0;
+void window_set_cursor(Window* win, int visible){
+    if(!win) return;
+    if(win->has_cursor) layout_touch(win, win->cursor_line);
+    win->has_cursor = visible ? 1 : 0;
+    if(win->has_cursor){
+        win->cursor_line = win->line_last;
+        win->cursor_col = win->line_len[LINE_IDX(win->line_last)];
+        layout_touch(win, win->line_last);
+    }
 }
 
 void window_key(Window* win, char c){
@@ -204,185 +373,132 @@ void window_key(Window* win, char c){
     if(win->on_key) win->on_key(c);
 }
 
-static void draw_close_btn(int x, int y, int s, int hot){
+static void draw_close_btn(Window* w, int x, int y, int s, int hot){
     uint32_t bg = hot ? 0x00D04040 : 0x00B03030;
-    fill_rect(x,y,s,s,bg);
-    draw_text8(x+3,y+3,"X",0x00FFFFFF);
+    surf_fill(w,x,y,s,s,bg);
+    draw_text8(w,x+3,y+3,"X",0x00FFFFFF);
 }
 
-static void draw_client_text(Window* w, int cx, int cy, int cw, int ch){
-    const int line_h = 10;
-    int max_lines = ch / line_h;
-    if(max_lines < 1) return;
-
-    // Colunas visíveis (fonte 8px + padding). Mantém o texto DENTRO da janela.
-    int cols = (cw - 8) / 8;
-    if(cols < 1) cols = 1;
-    if(cols > 240) cols = 240; // segurança
-
-    // Renderiza por "layout": aplica \n, wrap por colunas e \b (backspace)
-    // sem modificar o log real.
-    char lines[64][241];
-    int line_count = 0;
-    int cur_len = 0;
-    int cursor_line = -1;
-    int cursor_col  = -1;
-
-    // inicializa primeira linha
-    kmemset(lines, 0, sizeof(lines));
-    line_count = 1;
-
-    const char* buf = w->log;
-    size_t len = w->log_len;
-    for(size_t i=0; i<len; i++){
-        unsigned char chv = (unsigned char)buf[i];
-
-        if(chv == '\r') continue;
-
-        // Cursor marker (não imprime). Usado pelo shell.
-        if(chv == 0x1F){
-            cursor_line = line_count - 1;
-            cursor_col  = cur_len;
-            continue;
-        }
-
-        if(chv == '\n'){
-            // nova linha
-            if(line_count < 64){
-                line_count++;
-                cur_len = 0;
-            }
-            continue;
-        }
-
-        if(chv == '\b' || chv == 8){
-            // backspace: remove um char da linha atual
-            if(cur_len > 0){
-                cur_len--;
-                lines[line_count-1][cur_len] = 0;
-                // Se cursor estava após isso, anda junto
-                if(cursor_line == line_count-1 && cursor_col > cur_len) cursor_col = cur_len;
-            }
-            continue;
-        }
+// Desenha uma linha do layout no "slot" k (0 = linha de baixo).
+static void draw_line_slot(Window* w, uint32_t seq, int cx, int cy, int cw, int ch){
+    int k = (int)(w->line_last - seq);
+    int y = cy + ch - WIN_LINE_H * (k + 1);
+    surf_fill(w, cx, y, cw, WIN_LINE_H, 0x00FFFFFF);
+
+    uint32_t li = LINE_IDX(seq);
+    int len = w->line_len[li];
+    const char* text = w->line_text[li];
+    int tx = cx + 4;
+
+    for(int i=0; i<len; i++) draw_char8(w, tx + i*8, y+1, text[i], 0x00000000);
+
+    // Cursor piscando (500ms): '_' por cima da celula (o glifo e transparente,
+    // entao com a linha cheia o ultimo caractere continua visivel embaixo).
+    if(w->focused && w->has_cursor && w->cursor_line == seq && w->cursor_phase == 1){
+        int ccol = w->cursor_col;
+        if(ccol >= w->cols) ccol = w->cols - 1;  // cursor caiu no wrap
+        draw_char8(w, tx + ccol*8, y+1, '_', 0x00000000);
+    }
+}
 
-        // Apenas imprimíveis básicos
-        if(chv < 32 || chv > 126) continue;
-
-        // wrap
-        if(cur_len >= cols){
-            if(line_count < 64){
-                line_count++;
-                cur_len = 0;
-            } else {
-                // sem espaço: descarta chars extras
-                continue;
+// Atualiza o texto da área do cliente. Com `full`, desenha todas as linhas
+// visíveis; senão rola os pixels já prontos e redesenha só as linhas sujas.
+static void draw_client_text(Window* w, int full){
+    int cx, cy, cw, ch;
+    client_rect(w, &cx, &cy, &cw, &ch);
+
+    int vis = ch / WIN_LINE_H;
+    if(vis > WIN_MAX_LINES) vis = WIN_MAX_LINES;
+    if(vis < 1) return;
+
+    uint32_t count = w->line_last - w->line_first + 1;
+    uint32_t first_vis = (count > (uint32_t)vis) ? w->line_last - (uint32_t)(vis - 1) : w->line_first;
+    int region_y = cy + ch - vis * WIN_LINE_H;
+    int region_h = vis * WIN_LINE_H;
+    int damage_y = region_y;
+
+    uint32_t from = first_vis;
+    if(!full){
+        uint32_t shift = w->line_last - w->view_last;
+        if(shift >= (uint32_t)vis){
+            surf_fill(w, cx, region_y, cw, region_h, 0x00FFFFFF);
+        } else if(shift > 0){
+            // Scroll: sobe as linhas já desenhadas em vez de redesenhá-las.
+            int dy = (int)shift * WIN_LINE_H;
+            for(int y = region_y; y < region_y + region_h - dy; y++){
+                uint32_t* dst = w->surface + (uint32_t)y * (uint32_t)w->w + (uint32_t)cx;
+                const uint32_t* src = dst + (uint32_t)dy * (uint32_t)w->w;
+                for(int x=0; x<cw; x++) dst[x] = src[x];
             }
+            if(w->text_dirty_from > first_vis) from = w->text_dirty_from;
+        } else {
+            if(!w->text_dirty) return;
+            if(w->text_dirty_from > first_vis) from = w->text_dirty_from;
+            damage_y = cy + ch - WIN_LINE_H * (int)(w->line_last - from + 1);
         }
-
-        lines[line_count-1][cur_len++] = (char)chv;
-        lines[line_count-1][cur_len] = 0;
     }
 
-    // Cursor piscando (500ms). Se não tiver marker, não desenha cursor.
-    int cursor_on = 0;
-    if(w->focused && cursor_line >= 0 && cursor_col >= 0){
-        uint32_t t = time_get_ticks();
-        cursor_on = ((t / 500) & 1) ? 0 : 1;
+    for(uint32_t seq = from; seq != w->line_last + 1; seq++){
+        draw_line_slot(w, seq, cx, cy, cw, ch);
     }
 
-    // Seleciona as últimas linhas que cabem
-    int draw_lines = (line_count < max_lines) ? line_count : max_lines;
-    int start = line_count - draw_lines;
-
-    int y = cy + ch - line_h * draw_lines;
-    for(int li=0; li<draw_lines; li++){
-        char tmp[241];
-        kmemset(tmp, 0, sizeof(tmp));
-        kmemcpy(tmp, lines[start + li], 240);
-
-        // Aplica cursor se esta é a linha do cursor
-        if(cursor_on && (start + li) == cursor_line){
-            int ccol = cursor_col;
-            if(ccol < 0) ccol = 0;
-            if(ccol >= cols){
-                // cursor caiu no wrap: tenta desenhar no fim
-                ccol = cols - 1;
-            }
-            // garante terminador
-            if(ccol >= 240) ccol = 240;
-            // se cursor está além do fim atual, preenche com espaço
-            int cur_l = (int)kstrlen(tmp);
-            while(cur_l < ccol && cur_l < 240){ tmp[cur_l++] = ' '; }
-            if(ccol < 240){
-                tmp[ccol] = '_';
-                if(ccol+1 < 241) tmp[ccol+1] = 0;
-            }
-        }
-
-        draw_text8(cx+4, y+1, tmp, 0x00000000);
-        y += line_h;
-    }
+    w->view_last = w->line_last;
+    w->text_dirty = 0;
+    if(!full) comp_layer_damage(&w->layer, cx, damage_y, cw, (region_y + region_h) - damage_y);
 }
 
-// OTIMIZAÇÃO CRÍTICA: Não pinta o fundo cinza onde vai ser branco!
-static void window_draw_one(Window* win){
-    if(!win || win->closed) return;
-
-    const int border=2;
-    const int title_h=18;
-    const int btn=14;
+// Redesenha a superficie inteira (só chamado quando a janela está suja).
+static void window_render(Window* win){
+    const int W=win->w, H=win->h;
 
     uint32_t frame=0x00000000;
-    uint32_t bg=0x00E6E6E6;
     uint32_t title= win->focused ? 0x000A246A : 0x00606060;
 
     // 1. Bordas (Apenas as tiras, não o meio)
-    fill_rect(win->x, win->y, win->w, border, frame);               // Topo
-    fill_rect(win->x, win->y+win->h-border, win->w, border, frame); // Base
-    fill_rect(win->x, win->y, border, win->h, frame);               // Esq
-    fill_rect(win->x+win->w-border, win->y, border, win->h, frame); // Dir
+    surf_fill(win, 0, 0, W, WIN_BORDER, frame);              // Topo
+    surf_fill(win, 0, H-WIN_BORDER, W, WIN_BORDER, frame);   // Base
+    surf_fill(win, 0, 0, WIN_BORDER, H, frame);              // Esq
+    surf_fill(win, W-WIN_BORDER, 0, WIN_BORDER, H, frame);   // Dir
     
     // 2. Título
-    fill_rect(win->x+border, win->y+border, win->w-border*2, title_h, title);
-    draw_text8(win->x+border+6, win->y+border+4, win->title, 0x00FFFFFF);
+    surf_fill(win, WIN_BORDER, WIN_BORDER, W-WIN_BORDER*2, WIN_TITLE_H, title);
+    draw_text8(win, WIN_BORDER+6, WIN_BORDER+4, win->title, 0x00FFFFFF);
 
-    int bx = win->x + win->w - border - btn - 2;
-    int by = win->y + border + 2;
-    draw_close_btn(bx, by, btn, win->focused);
+    int bx = W - WIN_BORDER - WIN_BTN - 2;
+    int by = WIN_BORDER + 2;
+    draw_close_btn(win, bx, by, WIN_BTN, win->focused);
 
     // 3. Área do Cliente (Branco)
-    // Antes pintava de cinza aqui e depois de branco em cima. Agora pinta direto branco.
-    int cx = win->x + border;
-    int cy = win->y + border + title_h;
-    int cw = win->w - border*2;
-    int ch = win->h - border*2 - title_h;
-
-    // Se sobrar espaço entre titulo e cliente, pinte de cinza aqui (opcional)
-    // Mas para o shell, vamos direto pro branco
-    fill_rect(cx, cy, cw, ch, 0x00FFFFFF);
+    int cx, cy, cw, ch;
+    client_rect(win, &cx, &cy, &cw, &ch);
+    surf_fill(win, cx, cy, cw, ch, 0x00FFFFFF);
     
     // 4. Texto
-    draw_client_text(win, cx, cy, cw, ch);
+    draw_client_text(win, 1);
 }
 
+// Re-renderiza só as janelas sujas e deixa o compositor copiar o que mudou.
+// Janelas estáticas não custam nada por frame.
 void window_draw_all(void){
-    int drawn=0;
-    while(drawn < 128){
-        Window* best=NULL;
-        int bestz=(int)0x80000000;
-        for(Window* it=g_head; it; it=it->next){
-            if(it->closed) continue;
-            if(!best || it->z < bestz){ bestz=it->z; best=it; }
+    int phase = g_blink_phase;
+
+    for(Window* it=g_head; it; it=it->next){
+        if(it->closed) continue;
+        if(it->focused && it->cursor_phase != phase){
+            it->cursor_phase = phase;
+            if(it->has_cursor) layout_touch(it, it->cursor_line);
         }
-        if(!best) break;
 
-        int saved=best->z;
-        best->z = 0x7FFFFFFF;
-        window_draw_one(best);
-        best->z = saved;
-        drawn++;
+        if(it->dirty){
+            window_render(it);
+            it->dirty = 0;
+            comp_layer_damage(&it->layer, 0, 0, it->w, it->h);
+        } else if(it->text_dirty){
+            draw_client_text(it, 0);
+        }
     }
+
+    comp_compose();
 }
 
 // Hook
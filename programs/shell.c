@@ -25,16 +25,11 @@ extern void window_set_on_key(Window* win, void (*cb)(char));
 
 static Window* g_shell = NULL;
 
-// Cursor marker entendido pelo renderer da janela (window.c)
-#define SHELL_CURSOR_MARKER ((char)0x1F)
-
 static void shell_banner(void){
     window_write(g_shell, "Cinser Shell (test) ✅\n");
     window_write(g_shell, "TAB: troca foco | Ctrl+W: fecha janela\n");
     window_write(g_shell, "--------------------------------------\n");
     window_write(g_shell, "> ");
-    char m[2] = { SHELL_CURSOR_MARKER, 0 };
-    window_write(g_shell, m);
 }
 
 void shell_open(void){
@@ -42,6 +37,7 @@ void shell_open(void){
     g_shell = window_make("Shell", 40, 40, 560, 280);
     if(!g_shell) return;
     window_set_on_key(g_shell, shell_key);
+    window_set_cursor(g_shell, 1); // a janela mantém o cursor no fim do texto
     shell_banner();
 }
 
@@ -49,23 +45,15 @@ void shell_key(char c){
     if(!g_shell) return;
 
     if(c=='\r' || c=='\n'){
-        window_write(g_shell, "\n> ");
-        char m[2] = { SHELL_CURSOR_MARKER, 0 };
-        window_write(g_shell, m);
+        window_write_n(g_shell, "\n> ", 3);
         return;
     }
     if(c==8){
         // backspace real: o renderer interpreta '\b'
-        char bs[2] = { '\b', 0 };
-        window_write(g_shell, bs);
-        char m[2] = { SHELL_CURSOR_MARKER, 0 };
-        window_write(g_shell, m);
+        window_write_n(g_shell, "\b", 1);
         return;
     }
     if(c >= 32 && c <= 126){
-        char s[2] = { c, 0 };
-        window_write(g_shell, s);
-        char m[2] = { SHELL_CURSOR_MARKER, 0 };
-        window_write(g_shell, m);
+        window_write_n(g_shell, &c, 1);
     }
 }
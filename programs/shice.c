@@ -26,12 +26,23 @@
 #include "shice/shice_sinfetch.h"
 #include "shice/shice_date.h"
 #include "shice/shice_hour.h"
+#include "shice/shice_gfxbench.h"
+#include "shice/shice_tick.h"
+#include "shice/shice_irqstat.h"
+#include "shice/shice_top.h"
+#include "shice/shice_ps.h"
+#include "shice/shice_fiberbench.h"
+#include "shice/shice_cpus.h"
 #include "shice/shice_calc.h"
 #include "sysconfig.h"
 #include "memory.h"
 
 // Opcional: permitir entrar no UI se o usuario digitar "ui"
 #include "desktop.h"
+#include "video.h"
+#include "timer.h"
+#include "sched.h"
+#include "fiber.h"
 
 // util: string ops (freestanding)
 static int streq(const char* a, const char* b) {
@@ -59,102 +70,101 @@ static void put_prompt(void) {
 
 static void newline(void){ console_putc('\n'); }
 
-// Linha com cursor piscando (software) usando ticks do PIT.
+// Linha com cursor piscando (software).
 //
 // Importante:
 // - O console agora trata '\b' (backspace) em drivers/console.c.
 // - Aqui usamos o classico: \b ' ' \b para apagar na tela.
-// - O HLT acorda tanto por IRQ do teclado quanto do PIT, entao o blink funciona sem busy-loop.
+// - O blink roda numa fiber (fiber.h) acordada por um timer periodico; o
+//   read_line espera o teclado com fiber_wait, entao os dois se revezam sem
+//   busy-loop e o thread dorme em cpu_idle() quando nenhum tem o que fazer.
+#define BLINK_MS 500
+
+static int g_cursor_on = 0;
+static volatile int g_blink_stop = 0;
+static fiber_event_t g_blink_ev = FIBER_EVENT_INIT;
+static fiber_event_t g_blink_done = FIBER_EVENT_INIT;
+static fiber_event_t g_key_ev = FIBER_EVENT_POLL(keyboard_haschar);
+
+// Mostra/esconde o cursor de software na posicao atual
+static void cursor_show(int on) {
+    console_putc(on ? '_' : ' ');
+    console_putc('\b');
+    g_cursor_on = on;
+}
+
+static void blink_timer(void* arg) {
+    (void)arg;
+    fiber_signal(&g_blink_ev);
+}
+
+static void blink_fiber(void* arg) {
+    (void)arg;
+    for (;;) {
+        fiber_wait(&g_blink_ev);
+        if (g_blink_stop) break;
+        cursor_show(!g_cursor_on);
+    }
+    fiber_signal(&g_blink_done);
+}
+
 static int read_line(char* buf, int maxlen) {
     int len = 0;
 
-    // PIT em 1000 Hz por padrao => 500 ticks ~= 500 ms
-    const uint32_t BLINK_TICKS = 500;
-    uint32_t last_blink = time_get_ticks();
-    int cursor_on = 0;
-
     // mostra cursor no inicio
-    console_putc('_');
-    console_putc('\b');
-    cursor_on = 1;
+    cursor_show(1);
 
-    for (;;) {
-        if (keyboard_haschar()) {
-            int ch = keyboard_getchar();
-            if (ch < 0) {
-                __asm__ volatile("hlt");
-                continue;
-            }
-
-            char c = (char)ch;
+    // Sem fiber (sem memoria) a linha so nao pisca
+    g_blink_stop = 0;
+    g_blink_ev.pending = 0;
+    g_blink_done.pending = 0;
+    ktimer_t* blink = 0;
+    if (fiber_create("blink", blink_fiber, 0))
+        blink = timer_add_periodic(time_get_ticks() + BLINK_MS, BLINK_MS, blink_timer, 0);
 
-            // esconde cursor antes de imprimir/alterar
-            if (cursor_on) {
-                console_putc(' ');
-                console_putc('\b');
-                cursor_on = 0;
+    for (;;) {
+        fiber_wait(&g_key_ev);
+        int ch = keyboard_getchar();
+        if (ch < 0) continue;
+
+        char c = (char)ch;
+
+        // esconde cursor antes de imprimir/alterar
+        if (g_cursor_on) cursor_show(0);
+
+        // Enter
+        if (c == '\r' || c == '\n') {
+            if (blink) {
+                timer_cancel(blink);
+                g_blink_stop = 1;
+                fiber_signal(&g_blink_ev);
+                fiber_wait(&g_blink_done);
             }
+            newline();
+            buf[len] = 0;
+            return len;
+        }
 
-            // Enter
-            if (c == '\r' || c == '\n') {
-                newline();
+        // Backspace (8) or DEL (127)
+        if (c == 8 || c == 127) {
+            if (len > 0) {
+                len--;
                 buf[len] = 0;
-                return len;
-            }
-
-            // Backspace (8) or DEL (127)
-            if (c == 8 || c == 127) {
-                if (len > 0) {
-                    len--;
-                    buf[len] = 0;
-                    console_putc('\b');
-                    console_putc(' ');
-                    console_putc('\b');
-                }
-                // mostra cursor de novo
-                console_putc('_');
                 console_putc('\b');
-                cursor_on = 1;
-                continue;
-            }
-
-            // Ignore non-printables
-            if ((unsigned char)c < 32 || (unsigned char)c > 126) {
-                console_putc('_');
+                console_putc(' ');
                 console_putc('\b');
-                cursor_on = 1;
-                continue;
             }
-
+        } else if ((unsigned char)c >= 32 && (unsigned char)c <= 126) {
+            // Ignora nao-imprimiveis
             if (len < maxlen - 1) {
                 buf[len++] = c;
                 buf[len] = 0;
                 console_putc(c);
             }
-
-            // mostra cursor
-            console_putc('_');
-            console_putc('\b');
-            cursor_on = 1;
-            continue;
         }
 
-        // Blink quando estiver ocioso
-        uint32_t now = time_get_ticks();
-        if ((now - last_blink) >= BLINK_TICKS) {
-            last_blink = now;
-            if (cursor_on) {
-                console_putc(' ');
-                console_putc('\b');
-                cursor_on = 0;
-            } else {
-                console_putc('_');
-                console_putc('\b');
-                cursor_on = 1;
-            }
-        }
-
-        __asm__ volatile("hlt");
+        // mostra cursor de novo
+        cursor_show(1);
     }
 }
 
@@ -194,6 +204,70 @@ void shice_init(void) {
     shice_banner();
 }
 
+// Comandos que rodam tanto no prompt quanto em segundo plano (bg).
+// Retorna 0 se o comando nao existe.
+static int run_command(const char* s) {
+    if (streq(s, "help")) { shice_cmd_help(); return 1; }
+    if (streq(s, "clear")) { cmd_clear(); return 1; }
+    if (streq(s, "ver")) { cmd_ver(); return 1; }
+    if (streq(s, "sinfetch")) { shice_cmd_sinfetch(); return 1; }
+    if (starts_with(s, "calc")) { shice_cmd_calc(s); return 1; }
+    if (starts_with(s, "echo")) { cmd_echo(s); return 1; }
+    if (streq(s, "hour")) { print_rtc_time(); return 1; }
+    if (streq(s, "date")) { print_rtc_date(); return 1; }
+    if (streq(s, "gfxbench")) { shice_cmd_gfxbench(); return 1; }
+    if (starts_with(s, "tick")) { shice_cmd_tick(s); return 1; }
+    if (starts_with(s, "irqstat")) { shice_cmd_irqstat(s); return 1; }
+    if (starts_with(s, "top")) { shice_cmd_top(s); return 1; }
+    if (streq(s, "ps")) { shice_cmd_ps(); return 1; }
+    if (streq(s, "fiberbench")) { shice_cmd_fiberbench(); return 1; }
+    if (starts_with(s, "cpus")) { shice_cmd_cpus(s); return 1; }
+    return 0;
+}
+
+static void bg_thread(void* arg) {
+    char* cmd = (char*)arg;
+    run_command(cmd);
+    kfree(cmd);
+}
+
+// bg <comando>: roda o comando num thread de prioridade baixa; o prompt
+// volta na hora e o teclado preempta o comando.
+static void cmd_bg(const char* cmd) {
+    while (*cmd == ' ') cmd++;
+    if (!*cmd || streq(cmd, "ui") || starts_with(cmd, "bg")) {
+        console_write("Uso: bg <comando>\n");
+        return;
+    }
+
+    // A linha do prompt e reaproveitada: o thread leva a propria copia
+    int len = 0;
+    while (cmd[len]) len++;
+    char* copy = (char*)kmalloc((uint32_t)len + 1u);
+    if (!copy) { console_write("bg: sem memoria\n"); return; }
+    for (int i = 0; i <= len; i++) copy[i] = cmd[i];
+
+    // Nome "bg:<comando>" (cortado pelo escalonador se passar do limite)
+    char name[SCHED_NAME_MAX];
+    const char* pre = "bg:";
+    int n = 0;
+    for (; pre[n]; n++) name[n] = pre[n];
+    for (int i = 0; copy[i] && copy[i] != ' ' && n < SCHED_NAME_MAX - 1; i++) name[n++] = copy[i];
+    name[n] = 0;
+
+    thread_t* t = thread_create(name, bg_thread, copy, SCHED_PRIO_LOW);
+    if (!t) {
+        kfree(copy);
+        console_write("bg: nao foi possivel criar o thread\n");
+        return;
+    }
+    console_write("[");
+    print_int((int)t->id);
+    console_write("] ");
+    console_write(copy);
+    newline();
+}
+
 void shice_run(void) {
     shice_init();
 
@@ -208,47 +282,22 @@ void shice_run(void) {
         char* s = line;
         while (*s == ' ') s++;
 
-        if (streq(s, "help")) { shice_cmd_help(); continue; }
-        if (streq(s, "clear")) { cmd_clear(); continue; }
-        if (streq(s, "ver")) { cmd_ver(); continue; }
-        if (streq(s, "sinfetch")) { shice_cmd_sinfetch(); continue; }
-        if (starts_with(s, "calc")) { shice_cmd_calc(s); continue; }
-        if (starts_with(s, "echo")) { cmd_echo(s); continue; }
-        if (streq(s, "hour")) { print_rtc_time(); continue; }
-        if (streq(s, "date")) { print_rtc_date(); continue; }
+        if (starts_with(s, "bg ")) { cmd_bg(s + 3); continue; }
 
         if (streq(s, "ui")) {
+            if (!g_video_driver) {
+                console_write("UI requer framebuffer (modo texto ativo).\n");
+                continue;
+            }
             console_write("Entrando no desktop UI...\n");
             delay_ms(250);
-            desktop_init();
-
-            // Reusa a logica do kernel: loop do desktop
-            int need_redraw = 1;
-            uint32_t last_frame_time = 0;
-
-            for (;;) {
-                __asm__ volatile("hlt");
-
-                if (keyboard_haschar()) {
-                    while (keyboard_haschar()) {
-                        int ch = keyboard_getchar();
-                        if (ch > 0) {
-                            desktop_key((char)ch);
-                            need_redraw = 1;
-                        }
-                    }
-                }
-
-                if (need_redraw) {
-                    uint32_t now = time_get_ticks();
-                    if ((now - last_frame_time) < 16) continue;
-                    last_frame_time = now;
-                    desktop_draw();
-                    need_redraw = 0;
-                }
-            }
+
+            // Loop do desktop dirigido por eventos (nao retorna)
+            desktop_run();
         }
 
+        if (run_command(s)) continue;
+
         console_write("Comando desconhecido. Digite 'help'.\n");
     }
 }
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_cpus.c
+ * Descricao: Comando cpus: CPUs online e um teste de carga paralela em todas.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "clock.h"
+#include "math.h"
+#include "smp.h"
+#include "shice/shice_cpus.h"
+
+#define BENCH_LIMIT 400000u         // primos abaixo disso, divisao por tentativa
+
+// Numero alinhado a direita em 'width' colunas
+static void print_pad(uint32_t v, int width) {
+    char buf[11];
+    int n = 0;
+    do {
+        buf[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v && n < 10);
+    for (int i = n; i < width; i++) console_putc(' ');
+    while (n) console_putc(buf[--n]);
+}
+
+// Por mil -> "xx.x%"
+static void print_pm(uint32_t pm) {
+    print_int((int)(pm / 10u));
+    console_putc('.');
+    print_int((int)(pm % 10u));
+    console_putc('%');
+}
+
+// ---------------------------------------------------------------------------
+// cpus bench: cada CPU conta os primos de uma fatia intercalada dos impares
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t limit;
+    uint32_t ncpu;
+    volatile uint32_t count[SMP_MAX_CPUS];
+} prime_work_t;
+
+static int is_prime(uint32_t n) {
+    for (uint32_t d = 3; d * d <= n; d += 2)
+        if (n % d == 0) return 0;
+    return 1;
+}
+
+static void prime_part(void* arg) {
+    prime_work_t* w = (prime_work_t*)arg;
+    uint32_t k = (uint32_t)smp_cpu_id();
+    uint32_t c = 0;
+    for (uint32_t n = 3 + 2 * k; n < w->limit; n += 2 * w->ncpu)
+        if (is_prime(n)) c++;
+    w->count[k] = c;
+}
+
+// Primos abaixo de limit com 'ncpu' CPUs; *us recebe o tempo
+static uint32_t prime_run(prime_work_t* w, uint32_t ncpu, uint32_t* us) {
+    w->limit = BENCH_LIMIT;
+    w->ncpu = ncpu;
+    uint64_t t0 = clock_ns();
+    if (ncpu == 1) prime_part(w);
+    else smp_call_all(prime_part, w);
+    *us = (uint32_t)udiv64(clock_ns() - t0, 1000u, 0);
+
+    uint32_t total = 1;             // o 2
+    for (uint32_t i = 0; i < ncpu; i++) total += w->count[i];
+    return total;
+}
+
+static void print_run(const char* label, uint32_t primes, uint32_t us) {
+    console_write(label);
+    print_pad(us / 1000u, 6);
+    console_write(" ms  (");
+    print_int((int)primes);
+    console_write(" primos)\n");
+}
+
+static void cpus_bench(void) {
+    static prime_work_t w;
+    uint32_t n = (uint32_t)smp_cpu_count();
+    uint32_t us1, usn;
+
+    console_write("cpus bench: primos abaixo de ");
+    print_int((int)BENCH_LIMIT);
+    console_write("\n");
+
+    uint32_t p1 = prime_run(&w, 1, &us1);
+    print_run("  1 CPU  : ", p1, us1);
+    if (n < 2) {
+        console_write("  so ha uma CPU online\n");
+        return;
+    }
+    uint32_t pn = prime_run(&w, n, &usn);
+    console_write("  ");
+    print_int((int)n);
+    print_run(" CPUs : ", pn, usn);
+    if (pn != p1) console_write("  ERRO: contagens diferentes\n");
+
+    if (!usn) usn = 1;
+    uint32_t x10 = (uint32_t)udiv64((uint64_t)us1 * 10u, usn, 0);
+    console_write("  speedup: ");
+    print_int((int)(x10 / 10u));
+    console_putc('.');
+    print_int((int)(x10 % 10u));
+    console_write("x\n");
+}
+
+// ---------------------------------------------------------------------------
+
+// cpus        -> CPUs online: APIC ID, chamadas, wakeups e ocioso
+// cpus bench  -> mesma conta em 1 CPU e em todas
+void shice_cmd_cpus(const char* line) {
+    const char* arg = line + 4;     // depois de "cpus"
+    while (*arg == ' ') arg++;
+    if (arg[0] == 'b' && arg[1] == 'e' && arg[2] == 'n' && arg[3] == 'c' &&
+        arg[4] == 'h' && arg[5] == 0) {
+        cpus_bench();
+        return;
+    }
+    if (*arg) {
+        console_write("Uso: cpus [bench]\n");
+        return;
+    }
+
+    static smp_info_t info[SMP_MAX_CPUS];
+    int n = smp_snapshot(info, SMP_MAX_CPUS);
+
+    console_write("CPU  APIC  PAPEL  CHAMADAS  WAKEUPS  OCIOSO\n");
+    for (int i = 0; i < n; i++) {
+        print_pad(info[i].index, 3);
+        print_pad(info[i].apic_id, 6);
+        console_write(i == 0 ? "  BSP  " : "  AP   ");
+        print_pad(info[i].calls, 9);
+        print_pad(info[i].wakeups, 9);
+        console_write("  ");
+        print_pm(info[i].idle_pm);
+        console_write("\n");
+    }
+    print_int(n);
+    console_write(n == 1 ? " CPU online\n" : " CPUs online\n");
+}
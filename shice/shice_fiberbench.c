@@ -0,0 +1,84 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_fiberbench.c
+ * Descricao: Comando fiberbench: custo de uma troca de fiber e de thread em ciclos.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "clock.h"
+#include "math.h"
+#include "fiber.h"
+#include "sched.h"
+#include "shice/shice_fiberbench.h"
+
+#define BENCH_ROUNDS 10000
+
+static volatile int g_done;
+
+// O outro lado do ping-pong: cede BENCH_ROUNDS vezes e avisa que acabou
+static void ping_fiber(void* arg) {
+    (void)arg;
+    for (int i = 0; i < BENCH_ROUNDS; i++) fiber_yield();
+    g_done = 1;
+}
+
+static void ping_thread(void* arg) {
+    (void)arg;
+    for (int i = 0; i < BENCH_ROUNDS; i++) sched_yield();
+    g_done = 1;
+}
+
+static void print_cost(const char* label, uint64_t dt, uint32_t switches, const char* unit) {
+    console_write(label);
+    if (!switches) switches = 1;
+    print_u64(udiv64(dt, switches, 0));
+    console_write(unit);
+    console_write("/troca (");
+    print_u64(switches);
+    console_write(" trocas)\n");
+}
+
+void shice_cmd_fiberbench(void) {
+    const char* unit = clock_tsc_hz() ? " ciclos" : " ns";
+    uint32_t n;
+    uint64_t t0, dt;
+
+    console_write("fiberbench: ping-pong de ");
+    print_int(BENCH_ROUNDS);
+    console_write(" voltas\n");
+
+    // Fibers: so a troca de pilha, dentro deste thread
+    g_done = 0;
+    n = 0;
+    if (!fiber_create("bench", ping_fiber, 0)) {
+        console_write("fiberbench: sem memoria\n");
+        return;
+    }
+    t0 = clock_cycles();
+    while (!g_done) { fiber_yield(); n++; }
+    dt = clock_cycles() - t0;
+    print_cost("  fiber : ", dt, n + BENCH_ROUNDS, unit);
+
+    // Threads na mesma prioridade: escalonador, contabilidade e FPU lazy
+    g_done = 0;
+    n = 0;
+    if (!thread_create("bench", ping_thread, 0, sched_current()->prio)) {
+        console_write("  thread: escalonador inativo\n");
+        return;
+    }
+    t0 = clock_cycles();
+    while (!g_done) { sched_yield(); n++; }
+    dt = clock_cycles() - t0;
+    print_cost("  thread: ", dt, n + BENCH_ROUNDS, unit);
+}
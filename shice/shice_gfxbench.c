@@ -0,0 +1,108 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_gfxbench.c
+ * Descricao: Comando gfxbench: mede as primitivas de gfx.c (escalar x SSE2).
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "memory.h"
+#include "time.h"
+#include "gfx.h"
+#include "shice/shice_gfxbench.h"
+
+#define BENCH_W     256
+#define BENCH_H     256
+#define BENCH_ITERS 64
+
+enum { OP_FILL, OP_BLEND_FILL, OP_BLIT_ALPHA, OP_GRAD_H, OP_GRAD_V, OP_COUNT };
+
+static const char* const op_names[OP_COUNT] = {
+    "fill      ", "blend_fill", "blit_alpha", "gradient_h", "gradient_v",
+};
+
+static void run_op(int op, gfx_surface_t* s, const uint32_t* src) {
+    switch (op) {
+    case OP_FILL:       gfx_fill(s, 0, 0, BENCH_W, BENCH_H, 0x00336699u); break;
+    case OP_BLEND_FILL: gfx_blend_fill(s, 0, 0, BENCH_W, BENCH_H, 0x80FF8000u); break;
+    case OP_BLIT_ALPHA: gfx_blit_alpha(s, 0, 0, src, BENCH_W, BENCH_H, BENCH_W); break;
+    case OP_GRAD_H:     gfx_gradient_h(s, 0, 0, BENCH_W, BENCH_H, 0x00000000u, 0x00FFFFFFu); break;
+    case OP_GRAD_V:     gfx_gradient_v(s, 0, 0, BENCH_W, BENCH_H, 0x00203040u, 0x00C0D0E0u); break;
+    }
+}
+
+// Megapixels por segundo com uma casa decimal (so aritmetica de 32 bits).
+static void print_mps(uint32_t pixels, uint32_t ms) {
+    if (ms == 0) ms = 1;
+    uint32_t tenths = pixels / (ms * 100u);     // (px / ms) * 1000 / 1e6 * 10
+    print_int((int)(tenths / 10u));
+    console_putc('.');
+    print_int((int)(tenths % 10u));
+    console_write(" MP/s");
+}
+
+void shice_cmd_gfxbench(void) {
+    gfx_surface_t s;
+    s.w = BENCH_W;
+    s.h = BENCH_H;
+    s.stride = BENCH_W;
+    s.pixels = (uint32_t*)kmalloc(BENCH_W * BENCH_H * 4u);
+    uint32_t* src = (uint32_t*)kmalloc(BENCH_W * BENCH_H * 4u);
+    if (!s.pixels || !src) {
+        console_write("gfxbench: sem memoria\n");
+        if (s.pixels) kfree(s.pixels);
+        if (src) kfree(src);
+        return;
+    }
+
+    // Fonte com alpha variando por coluna (inclui 0 e 255 para os atalhos)
+    for (int y = 0; y < BENCH_H; y++)
+        for (int x = 0; x < BENCH_W; x++)
+            src[y * BENCH_W + x] = ((uint32_t)x << 24) | ((uint32_t)y << 8) | 0x40u;
+
+    int saved = gfx_backend();
+    const uint32_t pixels = (uint32_t)BENCH_W * BENCH_H * BENCH_ITERS;
+
+    console_write("gfxbench: 256x256, 64 iteracoes (ativo: ");
+    console_write(gfx_backend_name());
+    console_write(")\n");
+
+    for (int b = GFX_BACKEND_SCALAR; b <= GFX_BACKEND_SSE2; b++) {
+        if (!gfx_set_backend(b)) {
+            console_write("  [SSE2] nao suportado nesta CPU\n");
+            continue;
+        }
+        console_write("  [");
+        console_write(gfx_backend_name());
+        console_write("]\n");
+
+        for (int op = 0; op < OP_COUNT; op++) {
+            gfx_fill(&s, 0, 0, BENCH_W, BENCH_H, 0x00101010u);
+            uint32_t t0 = time_get_ticks();
+            for (int i = 0; i < BENCH_ITERS; i++) run_op(op, &s, src);
+            uint32_t ms = time_get_ticks() - t0;
+
+            console_write("    ");
+            console_write(op_names[op]);
+            console_write("  ");
+            print_int((int)ms);
+            console_write(" ms  ");
+            print_mps(pixels, ms);
+            console_putc('\n');
+        }
+    }
+
+    gfx_set_backend(saved);
+    kfree(src);
+    kfree(s.pixels);
+}
@@ -30,4 +30,17 @@ void shice_cmd_help(void) {
     console_write("  sinfetch - It displays information about the kernel, system, and hardware.\n");
     console_write("  time     - Show Time (xx:xx:xx)\n");
     console_write("  date     - Show Date (xx/xx/xx)\n");
+    console_write("  gfxbench - Benchmarks the 2D primitives (scalar vs SSE2)\n");
+    console_write("  tick     - Timer mode and timer IRQs per second\n");
+    console_write("  * tick [on|off] (tickless one-shot timer)\n");
+    console_write("  irqstat  - IRQ counts, handler/entry latency, IRQs-off sections\n");
+    console_write("  * irqstat [hist <irq>|reset|bench]\n");
+    console_write("  top      - CPU busy/idle per second, idle wakeups and idle work\n");
+    console_write("  * top [seconds]\n");
+    console_write("  ps       - Kernel threads: priority, state, CPU time, switches\n");
+    console_write("  bg       - Runs a command in a low-priority background thread\n");
+    console_write("  * bg <command>\n");
+    console_write("  fiberbench - Cost of a fiber switch vs a thread switch, in cycles\n");
+    console_write("  cpus     - Online CPU cores (APIC ID, IPI calls, idle)\n");
+    console_write("  * cpus [bench] (parallel prime count on every core)\n");
 }
\ No newline at end of file
@@ -16,7 +16,7 @@
 
 #include <stdint.h>
 #include "console.h"
-#include "cmos.h"
+#include "time.h"
 
 static void nl(void) { console_putc('\n'); }
 
@@ -26,8 +26,7 @@ static void print_2d(uint8_t v) {
 }
 
 void print_rtc_time(void) {
-    rtc_time_t t;
-    cmos_read_rtc(&t);
+    rtc_time_t t = time_now();
 
     print_2d(t.hour);
     console_putc(':');
@@ -0,0 +1,172 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_irqstat.c
+ * Descricao: Comando irqstat do Shice (contadores e latencia de IRQ)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "clock.h"
+#include "math.h"
+#include "irqstat.h"
+#include "softirq.h"
+#include "shice/shice_irqstat.h"
+
+static int streq(const char* a, const char* b) {
+    while (*a && *b) {
+        if (*a != *b) return 0;
+        a++; b++;
+    }
+    return *a == *b;
+}
+
+// Numero alinhado a direita em 'width' colunas
+static void print_pad(uint32_t v, int width) {
+    char buf[11];
+    int n = 0;
+    do {
+        buf[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v && n < 10);
+    for (int i = n; i < width; i++) console_putc(' ');
+    while (n) console_putc(buf[--n]);
+}
+
+static uint32_t to_ns(uint64_t cycles) {
+    uint64_t ns = clock_cycles_to_ns(cycles);
+    return (ns > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)ns;
+}
+
+static void print_avg_max(const irqstat_hist_t* h) {
+    uint64_t avg = h->count ? udiv64(h->total, h->count, 0) : 0;
+    print_pad(to_ns(avg), 9);
+    console_write(" /");
+    print_pad(to_ns(h->max), 9);
+}
+
+static void show_table(void) {
+    if (!irqstat_tsc) console_write("(sem TSC: so contagens)\n");
+    console_write("IRQ      count   handler avg/max (ns)     entry avg/max (ns)\n");
+    for (uint8_t irq = 0; irq < IRQSTAT_LINES; irq++) {
+        if (!irqstat_count(irq)) continue;
+        print_pad(irq, 3);
+        print_pad(irqstat_count(irq), 11);
+        console_write("  ");
+        print_avg_max(irqstat_handler(irq));
+        console_write("    ");
+        print_avg_max(irqstat_entry(irq));
+        console_write("\n");
+    }
+
+    console_write("Espurias (LAPIC): ");
+    print_int((int)irqstat_spurious);
+    console_write("   softirq timer/tasklet: ");
+    print_int((int)softirq_count(SOFTIRQ_TIMER));
+    console_write("/");
+    print_int((int)softirq_count(SOFTIRQ_TASKLET));
+    console_write("\n");
+
+    irqoff_site_t sites[IRQOFF_SITES];
+    int n = irqoff_sites(sites, IRQOFF_SITES);
+    if (n == 0) return;
+    console_write("IRQs desligadas (pior caso):\n");
+    for (int i = 0; i < n && i < 8; i++) {
+        console_write("  ");
+        print_pad(to_ns(sites[i].max), 9);
+        console_write(" ns  x");
+        print_int((int)sites[i].count);
+        console_write("  ");
+        console_write(sites[i].site);
+        console_write("\n");
+    }
+}
+
+static void show_hist(const char* title, const irqstat_hist_t* h) {
+    console_write(title);
+    console_write("\n");
+    for (int b = 0; b < IRQSTAT_BUCKETS; b++) {
+        if (!h->hist[b]) continue;
+        // Limite superior do balde em ns (o ultimo nao tem limite)
+        console_write(b == IRQSTAT_BUCKETS - 1 ? "  >=" : "  < ");
+        uint64_t edge = (b == IRQSTAT_BUCKETS - 1) ? (1ull << (b + 6)) : (1ull << (b + 7));
+        print_pad(to_ns(edge), 9);
+        console_write(" ns ");
+        print_pad(h->hist[b], 9);
+        console_write("\n");
+    }
+}
+
+#define BENCH_ROUNDS 8
+#define BENCH_INTS   1000
+
+// Menor media (ciclos por interrupcao) entre BENCH_ROUNDS rodadas de
+// BENCH_INTS 'int' de software, com IRQs desligadas.
+static uint32_t bench_path(int fast) {
+    uint64_t best = ~0ull;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        __asm__ volatile("cli");
+        uint64_t t0 = clock_cycles();
+        if (fast) {
+            for (int i = 0; i < BENCH_INTS; i++) __asm__ volatile("int $0x30" ::: "memory");
+        } else {
+            for (int i = 0; i < BENCH_INTS; i++) __asm__ volatile("int $0x31" ::: "memory");
+        }
+        uint64_t dt = clock_cycles() - t0;
+        __asm__ volatile("sti");
+        if (dt < best) best = dt;
+    }
+    return (uint32_t)udiv64(best, BENCH_INTS, 0);
+}
+
+static void show_bench(void) {
+    if (!irqstat_tsc) { console_write("irqstat bench: requer TSC\n"); return; }
+    uint32_t slow = bench_path(0);
+    uint32_t fast = bench_path(1);
+
+    console_write("Entrada+saida de IRQ (ciclos por interrupcao):\n");
+    console_write("  completo (recarrega segmentos, irq_dispatch):");
+    print_pad(slow, 7);
+    console_write("\n  rapido   (ring 0, handler direto + irq_exit):");
+    print_pad(fast, 7);
+    console_write("\n  economia:");
+    print_pad(slow > fast ? slow - fast : 0, 7);
+    console_write(" ciclos\n");
+}
+
+// irqstat            -> tabela por IRQ + secoes com IRQs desligadas
+// irqstat hist <n>   -> histogramas da IRQ n
+// irqstat reset      -> zera tudo
+// irqstat bench      -> custo do caminho rapido vs completo
+void shice_cmd_irqstat(const char* line) {
+    const char* arg = line + 7;     // depois de "irqstat"
+    while (*arg == ' ') arg++;
+
+    if (!*arg) {
+        show_table();
+    } else if (streq(arg, "reset")) {
+        irqstat_reset();
+    } else if (streq(arg, "bench")) {
+        show_bench();
+    } else if (arg[0] == 'h' && arg[1] == 'i' && arg[2] == 's' && arg[3] == 't' && arg[4] == ' ') {
+        const char* p = arg + 5;
+        while (*p == ' ') p++;
+        uint32_t irq = 0;
+        if (*p < '0' || *p > '9') { console_write("Uso: irqstat hist <irq>\n"); return; }
+        while (*p >= '0' && *p <= '9') irq = irq * 10u + (uint32_t)(*p++ - '0');
+        if (irq >= IRQSTAT_LINES) { console_write("irqstat: IRQ 0-15\n"); return; }
+        show_hist("Handler:", irqstat_handler((uint8_t)irq));
+        show_hist("Entrada (stub -> dispatch):", irqstat_entry((uint8_t)irq));
+    } else {
+        console_write("Uso: irqstat [hist <irq>|reset|bench]\n");
+    }
+}
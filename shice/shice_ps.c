@@ -0,0 +1,76 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_ps.c
+ * Descricao: Comando ps do Shice (threads do kernel)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "sched.h"
+#include "shice/shice_ps.h"
+
+#define PS_MAX 32
+
+// Numero alinhado a direita em 'width' colunas
+static void print_pad(uint32_t v, int width) {
+    char buf[11];
+    int n = 0;
+    do {
+        buf[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v && n < 10);
+    for (int i = n; i < width; i++) console_putc(' ');
+    while (n) console_putc(buf[--n]);
+}
+
+static const char* prio_name(uint8_t p) {
+    switch (p) {
+    case SCHED_PRIO_HIGH:   return "alta  ";
+    case SCHED_PRIO_NORMAL: return "normal";
+    case SCHED_PRIO_LOW:    return "baixa ";
+    default:                return "ocioso";
+    }
+}
+
+static const char* state_name(uint8_t s) {
+    switch (s) {
+    case THREAD_RUNNING: return "rodando ";
+    case THREAD_READY:   return "pronto  ";
+    case THREAD_BLOCKED: return "dormindo";
+    default:             return "morto   ";
+    }
+}
+
+void shice_cmd_ps(void) {
+    if (!sched_active()) {
+        console_write("ps: escalonador desligado\n");
+        return;
+    }
+
+    static sched_info_t info[PS_MAX];
+    int n = sched_snapshot(info, PS_MAX);
+
+    console_write(" ID  PRIO    ESTADO     CPU(ms)   TROCAS  NOME\n");
+    for (int i = n - 1; i >= 0; i--) {       // mais antigo primeiro
+        print_pad(info[i].id, 3);
+        console_write("  ");
+        console_write(prio_name(info[i].prio));
+        console_write("  ");
+        console_write(state_name(info[i].state));
+        print_pad(info[i].runtime_ms, 10);
+        print_pad(info[i].switches, 9);
+        console_write("  ");
+        console_write(info[i].name);
+        console_write("\n");
+    }
+}
@@ -20,6 +20,8 @@
 #include "console.h"
 #include "sysconfig.h"
 #include "memory.h"
+#include "clock.h"
+#include "cpu.h"
 #include "shice/shice_sinfetch.h"
 
 // Ajuste aqui se quiser outro nome fixo
@@ -129,9 +131,15 @@ static void write_u32_dec(uint32_t v) {
     while (i--) console_putc(buf[i]);
 }
 
-static void write_cpu_base_clock_ghz(void) {
-    // O usuário pediu BASE (fixo)
-    uint32_t mhz = sysconfig_cpu_base_mhz();
+static void write_cpu_clock_ghz(void) {
+    // Preferimos a frequencia medida (TSC calibrado contra o PIT); o CPUID
+    // 0x16 so existe em CPUs recentes e costuma vir zerado em VMs.
+    const char* src = " (TSC)";
+    uint32_t mhz = clock_cpu_mhz();
+    if (mhz == 0) {
+        mhz = sysconfig_cpu_base_mhz();
+        src = " (CPUID)";
+    }
 
     if (mhz == 0) {
         console_write("Unknown");
@@ -149,6 +157,30 @@ static void write_cpu_base_clock_ghz(void) {
     console_putc((char)('0' + (frac / 10u)));
     console_putc((char)('0' + (frac % 10u)));
     console_write("GHz");
+    console_write(src);
+}
+
+// Linha 'line' da lista de recursos da CPU quebrada em 'width' colunas.
+// Retorna 0 se a lista acabou antes dessa linha.
+static int write_cpu_flags_line(int line, int width) {
+    int cur = 0, col = 0, any = 0;
+    for (int f = 0; f < CPU_FEATURE_COUNT; f++) {
+        if (!cpu_has((cpu_feature_t)f)) continue;
+        const char* name = cpu_feature_name((cpu_feature_t)f);
+        int len = stlen(name);
+        if (col > 0 && col + 1 + len > width) {
+            if (cur == line) return any;
+            cur++;
+            col = 0;
+        }
+        if (cur == line) {
+            if (col > 0) console_putc(' ');
+            console_write(name);
+            any = 1;
+        }
+        col += (col > 0 ? 1 : 0) + len;
+    }
+    return any;
 }
 
 static void write_16_colors_blocks_2rows(int x, int y) {
@@ -194,6 +226,7 @@ void shice_cmd_sinfetch(void){
     const char* l5 = "RAM Use  ";
     const char* l6 = "Boot     ";
     const char* l7 = "Colors   ";
+    const char* l8 = "Features ";
 
     // layout do ícone
     int h = icon_lines();
@@ -249,6 +282,14 @@ void shice_cmd_sinfetch(void){
             console_set_cursor(spec_col, y);
             write_label_value(l2, cpu);
         }
+        if (y == spec_row0 + 4) {
+            console_set_cursor(spec_col, y);
+            console_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
+            console_write(l3);
+            console_write(": ");
+            console_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+            write_cpu_clock_ghz();
+        }
         if (y == spec_row0 + 5) {
             console_set_cursor(spec_col, y);
             write_label_value(l4, ram_total);
@@ -275,6 +316,20 @@ void shice_cmd_sinfetch(void){
             int x = spec_col + stlen(l7) + 2; // depois do "Colors   : "
             write_16_colors_blocks_2rows(x, y);
         }
+        // Recursos da CPU (cpu.h), quebrados na largura que sobra
+        if (y >= spec_row0 + 14) {
+            int line = y - (spec_row0 + 14);
+            int x = spec_col + stlen(l8) + 2;
+            console_set_cursor(x, y);
+            console_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+            int any = (x < cols) ? write_cpu_flags_line(line, cols - x - 1) : 0;
+            if (any && line == 0) {
+                console_set_cursor(spec_col, y);
+                console_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
+                console_write(l8);
+                console_write(": ");
+            }
+        }
     }
 
     console_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
@@ -0,0 +1,61 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_tick.c
+ * Descricao: Comando tick: modo do timer (periodico/tickless) e IRQs por segundo.
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "clock.h"
+#include "tick.h"
+#include "delay.h"
+#include "shice/shice_tick.h"
+
+static int streq(const char* a, const char* b) {
+    while (*a && *b) {
+        if (*a != *b) return 0;
+        a++; b++;
+    }
+    return *a == *b;
+}
+
+// tick          -> mostra modo e mede IRQs do timer em 1s
+// tick on|off   -> liga/desliga o tickless
+void shice_cmd_tick(const char* line) {
+    const char* arg = line + 4;     // depois de "tick"
+    while (*arg == ' ') arg++;
+
+    if (streq(arg, "on")) {
+        if (!tick_set_nohz(1)) console_write("tick: one-shot indisponivel (sem clocksource continuo)\n");
+    } else if (streq(arg, "off")) {
+        tick_set_nohz(0);
+    } else if (*arg) {
+        console_write("Uso: tick [on|off]\n");
+        return;
+    }
+
+    console_write("Timer     : ");
+    console_write(tick_device_name());
+    console_write(tick_is_nohz() ? " (one-shot, tickless)\n" : " (periodico)\n");
+    console_write("Clock     : ");
+    console_write(clock_source_name());
+    console_write("\n");
+
+    uint32_t c0 = tick_irq_count();
+    delay_ms(1000);
+    uint32_t c1 = tick_irq_count();
+
+    console_write("IRQs/s    : ");
+    print_int((int)(c1 - c0));
+    console_write("\n");
+}
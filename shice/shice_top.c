@@ -0,0 +1,102 @@
+/****************************************************************************
+ * Projeto: Tervia Cinser OS
+ * Arquivo: shice_top.c
+ * Descricao: Comando top do Shice (uso da CPU e trabalho ocioso)
+ * Copyright (C) 2026 Tervia Corporation.
+ *
+ * Este programa e um software livre: voce pode redistribui-lo e/ou
+ * modifica-lo sob os termos da Licenca Publica Geral GNU como publicada
+ * pela Free Software Foundation, bem como a versao 3 da Licenca.
+ *
+ * Este programa e distribuido na esperanca de que possa ser util,
+ * mas SEM NENHUMA GARANTIA; sem uma garantia implicita de ADEQUACAO
+ * a qualquer MERCADO ou APLICACAO EM PARTICULAR. Veja a
+ * Licenca Publica Geral GNU para mais detalhes.
+ ****************************************************************************/
+
+#include <stdint.h>
+#include "console.h"
+#include "delay.h"
+#include "math.h"
+#include "idle.h"
+#include "shice/shice_top.h"
+
+#define TOP_MAX_SAMPLES 60
+
+// Por mil -> "xx.x%"
+static void print_pm(uint32_t pm) {
+    if (pm > 1000u) pm = 1000u;
+    print_int((int)(pm / 10u));
+    console_putc('.');
+    print_int((int)(pm % 10u));
+    console_putc('%');
+}
+
+static void show_sample(void) {
+    idle_stats_t s;
+    idle_stats(&s);
+
+    console_write("CPU: ");
+    print_pm(s.busy_pm);
+    console_write(" ocupada, ");
+    print_pm(1000u - s.busy_pm);
+    console_write(" ociosa   wakeups/s: ");
+    print_int((int)s.wakeups);
+    console_write("\n");
+}
+
+// top       -> uso no ultimo segundo, media desde o boot e trabalho ocioso
+// top <n>   -> repete a linha de uso a cada segundo, n vezes
+void shice_cmd_top(const char* line) {
+    const char* arg = line + 3;     // depois de "top"
+    while (*arg == ' ') arg++;
+
+    int samples = 0;
+    while (*arg >= '0' && *arg <= '9') samples = samples * 10 + (*arg++ - '0');
+    if (*arg) {
+        console_write("Uso: top [segundos]\n");
+        return;
+    }
+    if (samples > TOP_MAX_SAMPLES) samples = TOP_MAX_SAMPLES;
+
+    if (samples > 0) {
+        for (int i = 0; i < samples; i++) {
+            delay_ms(1000);
+            show_sample();
+        }
+        return;
+    }
+
+    show_sample();
+
+    idle_stats_t s;
+    idle_stats(&s);
+    uint32_t total_ms = (uint32_t)udiv64(s.total_ns, 1000000u, 0);
+    uint32_t idle_ms = (uint32_t)udiv64(s.idle_ns, 1000000u, 0);
+    uint32_t idle_pm = total_ms ? (uint32_t)udiv64((uint64_t)idle_ms * 1000u, total_ms, 0) : 0;
+
+    console_write("Desde o boot: ");
+    print_pm(idle_pm);
+    console_write(" ociosa (");
+    print_int((int)idle_ms);
+    console_write(" de ");
+    print_int((int)total_ms);
+    console_write(" ms), ");
+    print_int((int)s.wakeups_total);
+    console_write(" wakeups\n");
+
+    console_write("Espera: ");
+    console_write(idle_method());
+    console_write("\n");
+
+    idle_work_t* w = idle_work_list();
+    if (!w) return;
+    console_write("Trabalho ocioso:\n");
+    for (; w; w = w->next) {
+        console_write("  ");
+        console_write(w->name);
+        console_write(": ");
+        print_int((int)w->runs);
+        console_write(" execucoes\n");
+    }
+}